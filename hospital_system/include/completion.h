@@ -0,0 +1,43 @@
+#ifndef COMPLETION_H
+#define COMPLETION_H
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+// SHM completion table (SHM6)
+//
+// Fixed array of completion slots indexed by operation_id so a surgery
+// worker blocked in wait_for_dependencies() gets its lab/pharmacy result
+// directly from shared memory - an O(1) wakeup instead of waiting for the
+// dispatcher to drain and match the response queue. Results are written
+// with atomic stores; the doorbell is one process-shared mutex/cond pair
+// broadcast on every post (waiters re-check their own slot on wake).
+
+#define COMPLETION_SLOTS   2048
+
+#define COMPLETION_PENDING 0
+#define COMPLETION_OK      1
+#define COMPLETION_FAIL   -1
+
+typedef struct {
+    _Atomic int lab_result;     // COMPLETION_PENDING / OK / FAIL
+    _Atomic int pharm_result;
+} completion_slot_t;
+
+typedef struct {
+    pthread_mutex_t mutex;      // Process-shared, guards the doorbell cond
+    pthread_cond_t cond;        // Process-shared, broadcast on every post
+    completion_slot_t slots[COMPLETION_SLOTS];
+} completion_shm_t;
+
+// --- Function Headers ---
+
+void completion_claim(int operation_id);
+void completion_post_lab(int operation_id, int success);
+void completion_post_pharm(int operation_id, int success);
+void completion_check(int operation_id, int *lab_result, int *pharm_result);
+int completion_timedwait(const struct timespec *abstime);
+void completion_broadcast(void);
+
+#endif
@@ -21,6 +21,8 @@ typedef struct {
 typedef struct {
     // Globals
     int time_unit_ms;
+    int virtual_time_enabled; // 1 = fast-forward clock over idle stretches
+    int results_journal_mode; // 1 = single per-run results journal instead of file-per-patient
     int max_emergency_patients;
     int max_appointments;
     int max_surgeries_pending;
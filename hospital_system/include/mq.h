@@ -148,13 +148,22 @@ typedef struct {
 } msg_restock_t;
 
 
+// Descriptor for one message in a batch send (messages may differ in size)
+typedef struct {
+    const void *msg_ptr;
+    size_t total_struct_size;
+} mq_batch_msg_t;
+
+
 // --- Function Headers ---
 
 // Message queues
 int create_all_message_queues();
 int remove_all_message_queues();
 int send_generic_message(int mq_id, const void *msg_ptr, size_t total_struct_size);
+int send_message_batch(int mq_id, const mq_batch_msg_t *msgs, int count);
 int receive_generic_message(int mq_id, void *msg_buffer, size_t total_struct_size, long max_priority_type);
+int receive_message_drain(int mq_id, void *msg_array, size_t total_struct_size, int max_count, long max_priority_type);
 int receive_specific_message(int mq_id, void *msg_buffer, size_t total_struct_size, long message_type);
 int receive_specific_message_nonblock(int mq_id, void *msg_buffer, size_t total_struct_size, long message_type);
 int receive_message_up_to_type(int mq_id, void *msg_buffer, size_t total_struct_size, long max_type);
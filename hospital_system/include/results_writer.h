@@ -0,0 +1,15 @@
+#ifndef RESULTS_WRITER_H
+#define RESULTS_WRITER_H
+
+#include <stddef.h>
+
+// Maximum size of one formatted results/delivery record
+#define RW_CONTENT_MAX 4096
+
+// --- Function Headers ---
+
+int results_writer_init(const char *component, const char *journal_path);
+int results_writer_enqueue(const char *filepath, const char *patient_id, const char *content);
+void results_writer_destroy(void);
+
+#endif
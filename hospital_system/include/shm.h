@@ -8,6 +8,7 @@
 #include "hospital.h"
 #include "stats.h"
 #include "log.h"
+#include "completion.h"
 
 // FTOK (update mq if changed)
 #define FTOK_PATH     "config/ipc.txt"
@@ -18,6 +19,7 @@
 #define SHM_PHARM_KEY 'P'
 #define SHM_LAB_KEY   'L'
 #define SHM_LOG_KEY   'G'
+#define SHM_COMPL_KEY 'C'
 
 // Hospital SHM memory structure
 typedef struct {
@@ -26,6 +28,7 @@ typedef struct {
     pharmacy_shm_t *shm_pharm;
     lab_queue_shm_t *shm_lab;
     critical_log_shm_t *shm_critical_logger;
+    completion_shm_t *shm_compl;
 } hospital_shm_t;
 
 // SHM
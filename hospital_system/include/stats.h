@@ -1,67 +1,93 @@
 #ifndef STATS_H
 #define STATS_H
 
+#include <stdatomic.h>
 #include <pthread.h>
 #include <time.h>
 
 #include "../include/config.h"
 
 // Global statistics (SHM1)
+//
+// Counters are C11 atomics grouped per component, with each section padded
+// to its own cache line so the four subsystems never false-share. Integer
+// counters use atomic fetch-add (plain ++ / += on _Atomic ints); the double
+// sums use the compiler-generated CAS loop behind atomic compound
+// assignment. Readers (display/snapshot) take no lock - each field is read
+// atomically, and exact cross-counter consistency is not required.
+
+#define STATS_CACHELINE 64
+#define VT_MAX_WAITERS  64
+
 typedef struct {
-    pthread_mutex_t mutex;
-    
     // --- Triage ---
-    int total_emergency_patients;
-    int total_appointments;
-    double total_emergency_wait_time;
-    double total_appointment_wait_time;
-    double total_triage_usage_time;
-    int completed_emergencies;
-    int completed_appointments;
-    int critical_transfers;
-    int rejected_patients;
-    
+    _Atomic int total_emergency_patients;
+    _Atomic int total_appointments;
+    _Atomic double total_emergency_wait_time;
+    _Atomic double total_appointment_wait_time;
+    _Atomic double total_triage_usage_time;
+    _Atomic int completed_emergencies;
+    _Atomic int completed_appointments;
+    _Atomic int critical_transfers;
+    _Atomic int rejected_patients;
+    char _pad_triage[STATS_CACHELINE];
+
     // --- BO ---
-    int total_surgeries_bo1;
-    int total_surgeries_bo2;
-    int total_surgeries_bo3;
-    double total_surgery_wait_time;
-    int completed_surgeries;
-    int cancelled_surgeries;
-    double bo1_utilization_time;
-    double bo2_utilization_time;
-    double bo3_utilization_time;
-    
+    _Atomic int total_surgeries_bo1;
+    _Atomic int total_surgeries_bo2;
+    _Atomic int total_surgeries_bo3;
+    _Atomic double total_surgery_wait_time;
+    _Atomic int completed_surgeries;
+    _Atomic int cancelled_surgeries;
+    _Atomic double bo1_utilization_time;
+    _Atomic double bo2_utilization_time;
+    _Atomic double bo3_utilization_time;
+    char _pad_surgery[STATS_CACHELINE];
+
     // --- Pharmacy ---
-    int total_pharmacy_requests;
-    int urgent_requests;
-    int normal_requests;
-    double total_pharmacy_response_time;
-    int stock_depletions; // Stock reached 0
-    int auto_restocks;
-    int manual_restocks;
-    int medication_usage[15]; 
+    _Atomic int total_pharmacy_requests;
+    _Atomic int urgent_requests;
+    _Atomic int normal_requests;
+    _Atomic double total_pharmacy_response_time;
+    _Atomic int stock_depletions; // Stock reached 0
+    _Atomic int auto_restocks;
+    _Atomic int manual_restocks;
+    _Atomic int medication_usage[15];
+    char _pad_pharmacy[STATS_CACHELINE];
 
     // --- Labs ---
-    int total_lab_tests_lab1;
-    int total_lab_tests_lab2;
-    double total_lab1_time;
-    double total_lab2_time;
-    int total_preop_tests;
-    double total_lab_turnaround_time;
-    int urgent_lab_tests;
+    _Atomic int total_lab_tests_lab1;
+    _Atomic int total_lab_tests_lab2;
+    _Atomic double total_lab1_time;
+    _Atomic double total_lab2_time;
+    _Atomic int total_preop_tests;
+    _Atomic double total_lab_turnaround_time;
+    _Atomic int urgent_lab_tests;
+    char _pad_lab[STATS_CACHELINE];
 
     // --- System ---
-    int total_operations;
-    int system_errors;
+    _Atomic int total_operations;
+    _Atomic int system_errors;
     time_t system_start_time;
-    int simulation_time_units;
+    char _pad_system[STATS_CACHELINE];
+
+    // Simulation clock on its own cache line - every wait loop reads it
+    _Atomic int simulation_time_units;
+    char _pad_clock[STATS_CACHELINE];
+
+    // --- Virtual time coordination (VIRTUAL_TIME_MODE=1) ---
+    // Blocked wait_time_units() callers register their wake deadline in a
+    // slot (0 = free) so the manager knows the next interesting instant;
+    // clock jumps are published under vt_mutex and broadcast on vt_cond.
+    pthread_mutex_t vt_mutex;
+    pthread_cond_t vt_cond;
+    _Atomic int vt_waiter_deadline[VT_MAX_WAITERS];
 } global_statistics_shm_t;
 
 // --- Function Headers ---
 
 void display_statistics_console(global_statistics_shm_t *stats, const char *component);
 void save_statistics_snapshot(global_statistics_shm_t *stats);
-void init_stats_default(global_statistics_shm_t *stats, pthread_mutexattr_t *attr);
+void init_stats_default(global_statistics_shm_t *stats);
 
-#endif
\ No newline at end of file
+#endif
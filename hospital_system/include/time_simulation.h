@@ -5,4 +5,8 @@ void wait_time_units(int units);
 int get_simulation_time(void);
 int diff_time_units(int start, int end);
 
+// Virtual time mode (manager side)
+int vt_earliest_deadline(void);
+void vt_publish_time(int new_time);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef TIMEOUT_HEAP_H
+#define TIMEOUT_HEAP_H
+
+// Deadline-indexed min-heap used by Triage and Surgery to track pending
+// entry timeouts. Entries are (deadline, operation id) pairs; the dispatcher
+// pops only actually-expired ids instead of walking the whole pending list
+// on every loop pass.
+//
+// The heap is NOT internally synchronized: callers protect it with the same
+// mutex that guards their pending list. Entries are removed lazily - an
+// operation completed before its deadline simply stays in the heap until the
+// deadline passes, at which point the pop returns an id that is no longer in
+// the pending list and the caller skips it.
+
+typedef struct {
+    int deadline;       // simulation time at which the entry expires
+    int op_id;          // operation/surgery id to look up in the pending list
+} timeout_entry_t;
+
+typedef struct {
+    timeout_entry_t *entries;
+    int count;
+    int capacity;
+} timeout_heap_t;
+
+// Returns 0 on success, -1 on allocation failure
+int timeout_heap_init(timeout_heap_t *heap, int initial_capacity);
+void timeout_heap_destroy(timeout_heap_t *heap);
+
+// Insert an entry. Grows the heap if needed. Returns 0 on success, -1 on
+// allocation failure (entry dropped; caller's linear timeout check is lost
+// for that id, which only delays its expiry logging).
+int timeout_heap_push(timeout_heap_t *heap, int deadline, int op_id);
+
+// Earliest deadline in the heap, or -1 if empty
+int timeout_heap_min_deadline(const timeout_heap_t *heap);
+
+// Pop the id with the earliest deadline if it expired at or before
+// current_time. Returns the id, or -1 if nothing has expired.
+int timeout_heap_pop_expired(timeout_heap_t *heap, int current_time);
+
+#endif
@@ -0,0 +1,83 @@
+#include <stdatomic.h>
+
+#include "../include/completion.h"
+#include "../include/shm.h"
+#include "../include/safe_threads.h"
+
+// Slots are indexed by operation_id modulo the table size. Operation ids
+// are unique and increasing per subsystem, so two in-flight operations only
+// collide if they are COMPLETION_SLOTS ids apart - claim() resets the slot
+// at submission time so a stale result can never satisfy a new operation.
+
+static completion_slot_t *slot_for(int operation_id) {
+    int idx = operation_id % COMPLETION_SLOTS;
+    if (idx < 0) idx += COMPLETION_SLOTS;
+    return &shm_hospital->shm_compl->slots[idx];
+}
+
+/**
+ * Reset the slot for a new operation (call before sending the requests)
+ */
+void completion_claim(int operation_id) {
+    if (!shm_hospital || !shm_hospital->shm_compl) return;
+    completion_slot_t *slot = slot_for(operation_id);
+    atomic_store(&slot->lab_result, COMPLETION_PENDING);
+    atomic_store(&slot->pharm_result, COMPLETION_PENDING);
+}
+
+// Store a result and ring the doorbell
+static void post_result(_Atomic int *field, int success) {
+    atomic_store(field, success ? COMPLETION_OK : COMPLETION_FAIL);
+
+    completion_shm_t *compl_shm = shm_hospital->shm_compl;
+    safe_pthread_mutex_lock(&compl_shm->mutex);
+    safe_pthread_cond_broadcast(&compl_shm->cond);
+    safe_pthread_mutex_unlock(&compl_shm->mutex);
+}
+
+void completion_post_lab(int operation_id, int success) {
+    if (!shm_hospital || !shm_hospital->shm_compl) return;
+    post_result(&slot_for(operation_id)->lab_result, success);
+}
+
+void completion_post_pharm(int operation_id, int success) {
+    if (!shm_hospital || !shm_hospital->shm_compl) return;
+    post_result(&slot_for(operation_id)->pharm_result, success);
+}
+
+/**
+ * Read the slot without blocking (results are COMPLETION_* codes)
+ */
+void completion_check(int operation_id, int *lab_result, int *pharm_result) {
+    if (!shm_hospital || !shm_hospital->shm_compl) {
+        *lab_result = COMPLETION_PENDING;
+        *pharm_result = COMPLETION_PENDING;
+        return;
+    }
+    completion_slot_t *slot = slot_for(operation_id);
+    *lab_result = atomic_load(&slot->lab_result);
+    *pharm_result = atomic_load(&slot->pharm_result);
+}
+
+/**
+ * Block on the doorbell until any post or the absolute timeout
+ * @return 0 on wakeup, ETIMEDOUT on timeout
+ */
+int completion_timedwait(const struct timespec *abstime) {
+    completion_shm_t *compl_shm = shm_hospital->shm_compl;
+    safe_pthread_mutex_lock(&compl_shm->mutex);
+    int rc = safe_pthread_cond_timedwait(&compl_shm->cond, &compl_shm->mutex, abstime);
+    safe_pthread_mutex_unlock(&compl_shm->mutex);
+    return rc;
+}
+
+/**
+ * Wake every waiter (used on shutdown)
+ */
+void completion_broadcast(void) {
+    if (!shm_hospital || !shm_hospital->shm_compl) return;
+    completion_shm_t *compl_shm = shm_hospital->shm_compl;
+    safe_pthread_mutex_lock(&compl_shm->mutex);
+    safe_pthread_cond_broadcast(&compl_shm->cond);
+    safe_pthread_mutex_unlock(&compl_shm->mutex);
+}
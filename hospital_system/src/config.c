@@ -83,6 +83,16 @@ static int validate_config() {
         log_event(ERROR, "CONFIG", "VALIDATION", buffer);
         valid = 0;
     }
+    if (config->virtual_time_enabled != 0 && config->virtual_time_enabled != 1) {
+        snprintf(buffer, sizeof(buffer), "VIRTUAL_TIME_MODE must be 0 or 1. Found: %d", config->virtual_time_enabled);
+        log_event(ERROR, "CONFIG", "VALIDATION", buffer);
+        valid = 0;
+    }
+    if (config->results_journal_mode != 0 && config->results_journal_mode != 1) {
+        snprintf(buffer, sizeof(buffer), "RESULTS_JOURNAL_MODE must be 0 or 1. Found: %d", config->results_journal_mode);
+        log_event(ERROR, "CONFIG", "VALIDATION", buffer);
+        valid = 0;
+    }
     if (config->max_emergency_patients <= 0) {
         snprintf(buffer, sizeof(buffer), "MAX_EMERGENCY_PATIENTS must be > 0. Found: %d", config->max_emergency_patients);
         log_event(ERROR, "CONFIG", "VALIDATION", buffer);
@@ -226,6 +236,8 @@ int load_config(const char *filename) {
         if (parse_config_line(line, &param)) {
             int is_standard = 1;
             if (strcmp(param.key, "TIME_UNIT_MS") == 0) config->time_unit_ms = atoi(param.value);
+            else if (strcmp(param.key, "VIRTUAL_TIME_MODE") == 0) config->virtual_time_enabled = atoi(param.value);
+            else if (strcmp(param.key, "RESULTS_JOURNAL_MODE") == 0) config->results_journal_mode = atoi(param.value);
             else if (strcmp(param.key, "MAX_EMERGENCY_PATIENTS") == 0) config->max_emergency_patients = atoi(param.value);
             else if (strcmp(param.key, "MAX_APPOINTMENTS") == 0) config->max_appointments = atoi(param.value);
             else if (strcmp(param.key, "MAX_SURGERIES_PENDING") == 0) config->max_surgeries_pending = atoi(param.value);
@@ -296,6 +308,7 @@ void print_configs() {
     // Global Settings
     printf("=== GLOBAL SETTINGS ===\n");
     printf("Time Unit (ms): %d\n", config->time_unit_ms);
+    printf("Virtual Time Mode: %s\n", config->virtual_time_enabled ? "ENABLED" : "DISABLED");
     printf("Max Emergency Patients: %d\n", config->max_emergency_patients);
     printf("Max Appointments: %d\n", config->max_appointments);
     printf("Max Surgeries Pending: %d\n", config->max_surgeries_pending);
@@ -347,6 +360,8 @@ int init_default_config() {
 
     // --- GLOBAL SETTINGS ---
     config->time_unit_ms = 500;
+    config->virtual_time_enabled = 0;
+    config->results_journal_mode = 0;
     config->max_emergency_patients = 50;
     config->max_appointments = 100;
     config->max_surgeries_pending = 30;
@@ -6,84 +6,221 @@
 #include "../include/mq.h"
 #include "../include/log.h"
 
+// --- Scheduled event storage ---
+//
+// Events sit in a binary min-heap keyed on (init_time, seq) so insertion is
+// O(log n) instead of the old sorted-list walk, and the next deadline is an
+// O(1) peek for the manager's select() timeout. Nodes come from a slab
+// allocator with the message payload inline, so scheduling an event costs no
+// malloc on the steady state (the slab grows in blocks and nodes recycle
+// through a free list).
+
+#define SCHED_MSG_INLINE_MAX  256   // Covers every message struct in mq.h
+#define SCHED_SLAB_BLOCK      256   // Nodes added per slab growth
+#define SCHED_HEAP_INITIAL_CAP 1024
+
+// Max due events pushed per send_message_batch() call
+#define DISPATCH_BATCH_MAX 64
+
 typedef struct ScheduledEvent {
     int init_time;
+    unsigned long seq;        // Tie-breaker: keeps FIFO order within a tick
     int mq_id;
-    void *msg_data;
     size_t msg_size;
-    struct ScheduledEvent *next;
+    unsigned char *msg_data;  // Points at inline_buf, or malloc'd if oversized
+    unsigned char inline_buf[SCHED_MSG_INLINE_MAX];
+    struct ScheduledEvent *next_free;
 } ScheduledEvent;
 
-static ScheduledEvent *scheduled_events_head = NULL;
+typedef struct SlabBlock {
+    struct SlabBlock *next;
+    ScheduledEvent nodes[SCHED_SLAB_BLOCK];
+} SlabBlock;
+
+static SlabBlock *slab_blocks = NULL;
+static ScheduledEvent *event_free_list = NULL;
+
+static ScheduledEvent **event_heap = NULL;
+static int event_count = 0;
+static int event_capacity = 0;
+static unsigned long next_event_seq = 0;
+
+// --- Slab allocator ---
+
+static ScheduledEvent *event_alloc(void) {
+    if (!event_free_list) {
+        SlabBlock *block = malloc(sizeof(SlabBlock));
+        if (!block) return NULL;
+        block->next = slab_blocks;
+        slab_blocks = block;
+        for (int i = SCHED_SLAB_BLOCK - 1; i >= 0; i--) {
+            block->nodes[i].next_free = event_free_list;
+            event_free_list = &block->nodes[i];
+        }
+    }
+    ScheduledEvent *e = event_free_list;
+    event_free_list = e->next_free;
+    return e;
+}
+
+static void event_free(ScheduledEvent *e) {
+    if (e->msg_data != e->inline_buf) {
+        free(e->msg_data);
+    }
+    e->next_free = event_free_list;
+    event_free_list = e;
+}
+
+// --- Min-heap primitives ---
+
+static int event_before(const ScheduledEvent *a, const ScheduledEvent *b) {
+    if (a->init_time != b->init_time) return a->init_time < b->init_time;
+    return a->seq < b->seq;
+}
+
+static void heap_swap(int a, int b) {
+    ScheduledEvent *tmp = event_heap[a];
+    event_heap[a] = event_heap[b];
+    event_heap[b] = tmp;
+}
+
+static void heap_sift_up(int idx) {
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        if (!event_before(event_heap[idx], event_heap[parent])) break;
+        heap_swap(idx, parent);
+        idx = parent;
+    }
+}
+
+static void heap_sift_down(int idx) {
+    for (;;) {
+        int smallest = idx;
+        int left = 2 * idx + 1;
+        int right = 2 * idx + 2;
+        if (left < event_count && event_before(event_heap[left], event_heap[smallest])) smallest = left;
+        if (right < event_count && event_before(event_heap[right], event_heap[smallest])) smallest = right;
+        if (smallest == idx) break;
+        heap_swap(idx, smallest);
+        idx = smallest;
+    }
+}
+
+static int heap_push(ScheduledEvent *e) {
+    if (event_count == event_capacity) {
+        int new_cap = (event_capacity > 0) ? event_capacity * 2 : SCHED_HEAP_INITIAL_CAP;
+        ScheduledEvent **grown = realloc(event_heap, new_cap * sizeof(ScheduledEvent *));
+        if (!grown) return -1;
+        event_heap = grown;
+        event_capacity = new_cap;
+    }
+    event_heap[event_count] = e;
+    event_count++;
+    heap_sift_up(event_count - 1);
+    return 0;
+}
+
+static ScheduledEvent *heap_pop(void) {
+    if (event_count == 0) return NULL;
+    ScheduledEvent *top = event_heap[0];
+    event_count--;
+    if (event_count > 0) {
+        event_heap[0] = event_heap[event_count];
+        heap_sift_down(0);
+    }
+    return top;
+}
+
+// --- Public API ---
 
 void add_scheduled_event(int init_time, int mq_id, void *msg, size_t size) {
-    ScheduledEvent *new_event = (ScheduledEvent *)malloc(sizeof(ScheduledEvent));
+    ScheduledEvent *new_event = event_alloc();
     if (!new_event) {
         log_event(ERROR, "SCHEDULER", "ALLOC_FAIL", "Failed to schedule event");
         return;
     }
 
     new_event->init_time = init_time;
+    new_event->seq = next_event_seq++;
     new_event->mq_id = mq_id;
     new_event->msg_size = size;
-    new_event->msg_data = malloc(size);
-    if (!new_event->msg_data) {
-        log_event(ERROR, "SCHEDULER", "ALLOC_FAIL", "Failed to schedule event");
-        free(new_event);
-        return;
+
+    if (size <= SCHED_MSG_INLINE_MAX) {
+        new_event->msg_data = new_event->inline_buf;
+    } else {
+        new_event->msg_data = malloc(size);
+        if (!new_event->msg_data) {
+            log_event(ERROR, "SCHEDULER", "ALLOC_FAIL", "Failed to schedule event");
+            new_event->msg_data = new_event->inline_buf; // So event_free() is safe
+            event_free(new_event);
+            return;
+        }
     }
     memcpy(new_event->msg_data, msg, size);
-    new_event->next = NULL;
-
-    // Insert into linked list (sorted by init_time ascending)
-    if (!scheduled_events_head || scheduled_events_head->init_time > init_time) {
-        new_event->next = scheduled_events_head;
-        scheduled_events_head = new_event;
-    } 
-    else {
-        ScheduledEvent *current = scheduled_events_head;
-        while (current->next && current->next->init_time <= init_time) {
-            current = current->next;
-        }
-        new_event->next = current->next;
-        current->next = new_event;
+
+    if (heap_push(new_event) != 0) {
+        log_event(ERROR, "SCHEDULER", "ALLOC_FAIL", "Failed to schedule event");
+        event_free(new_event);
     }
 }
 
 void process_scheduled_events(int current_time) {
-    while (scheduled_events_head && scheduled_events_head->init_time <= current_time) {
-        ScheduledEvent *current = scheduled_events_head;
-        
-        // Execute event
-        send_generic_message(current->mq_id, current->msg_data, current->msg_size);
-
-        // Remove from list (head)
-        scheduled_events_head = current->next;
-        
-        free(current->msg_data);
-        free(current);
+    mq_batch_msg_t batch[DISPATCH_BATCH_MAX];
+    ScheduledEvent *drained[DISPATCH_BATCH_MAX];
+
+    while (event_count > 0 && event_heap[0]->init_time <= current_time) {
+        // Collect the run of due events targeting the same queue
+        int batch_mq = event_heap[0]->mq_id;
+        int count = 0;
+
+        while (event_count > 0 &&
+               event_heap[0]->init_time <= current_time &&
+               event_heap[0]->mq_id == batch_mq &&
+               count < DISPATCH_BATCH_MAX) {
+            ScheduledEvent *current = heap_pop();
+            batch[count].msg_ptr = current->msg_data;
+            batch[count].total_struct_size = current->msg_size;
+            drained[count] = current;
+            count++;
+        }
+
+        // Execute the whole burst with one batched send
+        send_message_batch(batch_mq, batch, count);
+
+        for (int i = 0; i < count; i++) {
+            event_free(drained[i]);
+        }
     }
 }
 
 int get_next_scheduled_time(void) {
-    if (scheduled_events_head) {
-        return scheduled_events_head->init_time;
+    if (event_count > 0) {
+        return event_heap[0]->init_time;
     }
     return -1;
 }
 
 int has_scheduled_events(void) {
-    return (scheduled_events_head != NULL);
+    return (event_count > 0);
 }
 
 void cleanup_scheduler(void) {
-    while (scheduled_events_head) {
-        ScheduledEvent *temp = scheduled_events_head;
-        scheduled_events_head = scheduled_events_head->next;
-        
-        if (temp->msg_data) {
-            free(temp->msg_data);
+    // Release any oversized payloads still queued
+    for (int i = 0; i < event_count; i++) {
+        if (event_heap[i]->msg_data != event_heap[i]->inline_buf) {
+            free(event_heap[i]->msg_data);
         }
-        free(temp);
     }
+    event_count = 0;
+
+    free(event_heap);
+    event_heap = NULL;
+    event_capacity = 0;
+
+    while (slab_blocks) {
+        SlabBlock *next = slab_blocks->next;
+        free(slab_blocks);
+        slab_blocks = next;
+    }
+    event_free_list = NULL;
 }
@@ -21,6 +21,8 @@
 #include "../include/time_simulation.h"
 #include "../include/manager_utils.h"
 #include "../include/pipes.h"
+#include "../include/results_writer.h"
+#include "../include/completion.h"
 
 // --- Constants ---
 #define LAB1_ID         1   // Hematology
@@ -66,8 +68,17 @@ typedef struct {
     pthread_cond_t cond;
 } job_queue_t;
 
-// Global job queue instance
-static job_queue_t job_queue;
+// Per-lab job queues (index 0 = LAB1, 1 = LAB2). Jobs route to the queue of
+// the lab that owns most of their tests; workers have a home queue but steal
+// from the other one when theirs runs dry and the other is backed up.
+static job_queue_t lab_queues[2];
+
+// Other queue must hold at least this many jobs before an idle worker steals,
+// so a lone job is left for its own lab's workers and the queue mutexes don't
+// thrash when both labs are busy
+#define LAB_STEAL_WATERMARK 2
+
+static int get_target_lab(int test_id);
 
 /**
  * Check if the lab should shutdown (thread-safe)
@@ -75,9 +86,9 @@ static job_queue_t job_queue;
  */
 static int lab_should_shutdown(void) {
     int val;
-    safe_pthread_mutex_lock(&job_queue.mutex);
-    val = job_queue.shutdown;
-    safe_pthread_mutex_unlock(&job_queue.mutex);
+    safe_pthread_mutex_lock(&lab_queues[0].mutex);
+    val = lab_queues[0].shutdown;
+    safe_pthread_mutex_unlock(&lab_queues[0].mutex);
     return val;
 }
 
@@ -160,39 +171,87 @@ static int job_queue_push(job_queue_t *q, const msg_lab_request_t *request) {
     return 0;
 }
 
+/**
+ * Dequeue the head job with the mutex already held
+ */
+static lab_job_t* job_queue_take_locked(job_queue_t *q) {
+    lab_job_t *job = q->head;
+    q->head = job->next;
+    if (q->head == NULL) {
+        q->tail = NULL;
+    }
+    q->count--;
+    return job;
+}
+
+/**
+ * Pop a job without blocking (used for the home queue and for stealing)
+ * @return pointer to job, or NULL if the queue is empty or shutting down
+ */
+static lab_job_t* job_queue_try_pop(job_queue_t *q) {
+    safe_pthread_mutex_lock(&q->mutex);
+    if (q->head == NULL || q->shutdown) {
+        safe_pthread_mutex_unlock(&q->mutex);
+        return NULL;
+    }
+    lab_job_t *job = job_queue_take_locked(q);
+    safe_pthread_mutex_unlock(&q->mutex);
+    return job;
+}
+
 /**
  * Pop a job from the queue (consumer/worker side)
- * Blocks until a job is available or shutdown is signaled
- * @return pointer to job on success, NULL if shutdown signaled
+ * Blocks up to 100ms so the caller can periodically retry stealing
+ * @return pointer to job, or NULL on timeout or shutdown
  */
 static lab_job_t* job_queue_pop(job_queue_t *q) {
     safe_pthread_mutex_lock(&q->mutex);
-    
-    // Wait for a job or shutdown signal
-    // Use regular cond_wait - shutdown will broadcast to wake all waiters
-    while (q->head == NULL && !q->shutdown) {
-        safe_pthread_cond_wait(&q->cond, &q->mutex);
+
+    // Wait for a job or shutdown signal, bounded so the worker can go back
+    // and check the other lab's queue
+    if (q->head == NULL && !q->shutdown) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 100000000L; // 100ms
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        safe_pthread_cond_timedwait(&q->cond, &q->mutex, &ts);
     }
-    
+
     // If shutdown is signaled, exit immediately (don't process remaining jobs)
-    if (q->shutdown) {
+    if (q->head == NULL || q->shutdown) {
         safe_pthread_mutex_unlock(&q->mutex);
         return NULL;
     }
-    
-    // Pop from head of queue
-    lab_job_t *job = q->head;
-    q->head = job->next;
-    if (q->head == NULL) {
-        q->tail = NULL;
-    }
-    q->count--;
-    
+
+    lab_job_t *job = job_queue_take_locked(q);
+
     safe_pthread_mutex_unlock(&q->mutex);
-    
+
     return job;
 }
 
+/**
+ * Pick the queue for a new request: the lab that owns most of its tests,
+ * with ties (and PREOP, which spans both labs) going to the shorter queue
+ */
+static int classify_job_queue(const msg_lab_request_t *request) {
+    int lab1_tests = 0;
+    int lab2_tests = 0;
+
+    for (int i = 0; i < request->tests_count && i < 5; i++) {
+        int lab_id = get_target_lab(request->tests_id[i]);
+        if (lab_id == LAB1_ID) lab1_tests++;
+        else if (lab_id == LAB2_ID) lab2_tests++;
+    }
+
+    if (lab1_tests > lab2_tests) return 0;
+    if (lab2_tests > lab1_tests) return 1;
+    return (lab_queues[0].count <= lab_queues[1].count) ? 0 : 1;
+}
+
 /**
  * Signal all workers to shutdown
  */
@@ -385,52 +444,56 @@ static void generate_test_result(int test_id, char *result_buf, size_t buf_size)
 
 static int write_results_file(const char *patient_id, int tests_count, int *tests_id, time_t request_time, time_t completion_time) {
     char filepath[256];
-    snprintf(filepath, sizeof(filepath), "results/lab_results/%s_%ld.txt", 
+    snprintf(filepath, sizeof(filepath), "results/lab_results/%s_%ld.txt",
              patient_id, (long)completion_time);
-    
-    FILE *fp = fopen(filepath, "w");
-    if (!fp) {
-        char log_msg[512];
-        snprintf(log_msg, sizeof(log_msg), "Failed to create results file: %s", filepath);
-        log_event(ERROR, "LAB", "FILE_ERROR", log_msg);
-        return -1;
-    }
-    
+
     // Use thread-safe ctime_r() instead of ctime() to avoid race condition
     // on the static buffer used by ctime()/asctime()
     char request_time_str[26];
     char completion_time_str[26];
     ctime_r(&request_time, request_time_str);
     ctime_r(&completion_time, completion_time_str);
-    
-    fprintf(fp, "============================================\n");
-    fprintf(fp, "       LABORATORY ANALYSIS REPORT\n");
-    fprintf(fp, "============================================\n\n");
-    fprintf(fp, "Patient ID:      %s\n", patient_id);
-    fprintf(fp, "Request Time:    %s", request_time_str);
-    fprintf(fp, "Completion Time: %s", completion_time_str);
-    fprintf(fp, "Tests Performed: %d\n\n", tests_count);
-    fprintf(fp, "--------------------------------------------\n");
-    fprintf(fp, "                 RESULTS\n");
-    fprintf(fp, "--------------------------------------------\n\n");
-    
-    for (int i = 0; i < tests_count; i++) {
+
+    // Format the whole report in memory and hand it to the async writer;
+    // the worker keeps its equipment slot free of filesystem latency
+    char report[RW_CONTENT_MAX];
+    size_t off = 0;
+
+    off += snprintf(report + off, sizeof(report) - off,
+        "============================================\n"
+        "       LABORATORY ANALYSIS REPORT\n"
+        "============================================\n\n"
+        "Patient ID:      %s\n"
+        "Request Time:    %s"
+        "Completion Time: %s"
+        "Tests Performed: %d\n\n"
+        "--------------------------------------------\n"
+        "                 RESULTS\n"
+        "--------------------------------------------\n\n",
+        patient_id, request_time_str, completion_time_str, tests_count);
+
+    for (int i = 0; i < tests_count && off < sizeof(report); i++) {
         char result_buf[256];
         generate_test_result(tests_id[i], result_buf, sizeof(result_buf));
-        fprintf(fp, "[%s]\n", get_test_name(tests_id[i]));
-        fprintf(fp, "  %s\n\n", result_buf);
+        off += snprintf(report + off, sizeof(report) - off,
+            "[%s]\n  %s\n\n", get_test_name(tests_id[i]), result_buf);
     }
-    
-    fprintf(fp, "--------------------------------------------\n");
-    fprintf(fp, "Report generated by Hospital Lab System\n");
-    fprintf(fp, "============================================\n");
-    
-    fclose(fp);
-    
+
+    if (off < sizeof(report)) {
+        off += snprintf(report + off, sizeof(report) - off,
+            "--------------------------------------------\n"
+            "Report generated by Hospital Lab System\n"
+            "============================================\n");
+    }
+
+    if (results_writer_enqueue(filepath, patient_id, report) != 0) {
+        return -1;
+    }
+
     char log_msg[512];
-    snprintf(log_msg, sizeof(log_msg), "Results file created: %s", filepath);
+    snprintf(log_msg, sizeof(log_msg), "Results queued: %s", filepath);
     log_event(INFO, "LAB", "RESULTS_FILE", log_msg);
-    
+
     return 0;
 }
 
@@ -466,13 +529,11 @@ static int execute_normal_test(int test_id, const char *patient_id) {
     }
     
     // Update statistics
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     if (lab_id == LAB1_ID) {
         shm_hospital->shm_stats->total_lab_tests_lab1++;
     } else {
         shm_hospital->shm_stats->total_lab_tests_lab2++;
     }
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     // Simulate test duration
     int start_time = get_simulation_time();
@@ -480,13 +541,11 @@ static int execute_normal_test(int test_id, const char *patient_id) {
     int end_time = get_simulation_time();
     
     // Update lab time statistics
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     if (lab_id == LAB1_ID) {
         shm_hospital->shm_stats->total_lab1_time += (end_time - start_time);
     } else {
         shm_hospital->shm_stats->total_lab2_time += (end_time - start_time);
     }
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     // Release lab equipment
     release_lab_equipment(lab_id);
@@ -528,9 +587,7 @@ static int execute_preop_test(const char *patient_id) {
     }
     
     // Update LAB1 stats
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->total_lab_tests_lab1++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     // Simulate Phase 1
     int phase1_start = get_simulation_time();
@@ -538,9 +595,7 @@ static int execute_preop_test(const char *patient_id) {
     int phase1_end = get_simulation_time();
     
     // Update LAB1 time
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->total_lab1_time += (phase1_end - phase1_start);
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     // Release LAB1 before acquiring LAB2
     release_lab_equipment(LAB1_ID);
@@ -563,9 +618,7 @@ static int execute_preop_test(const char *patient_id) {
     }
     
     // Update LAB2 stats
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->total_lab_tests_lab2++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     // Simulate Phase 2
     int phase2_start = get_simulation_time();
@@ -573,10 +626,8 @@ static int execute_preop_test(const char *patient_id) {
     int phase2_end = get_simulation_time();
     
     // Update LAB2 time
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->total_lab2_time += (phase2_end - phase2_start);
     shm_hospital->shm_stats->total_preop_tests++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     // Release LAB2
     release_lab_equipment(LAB2_ID);
@@ -618,7 +669,11 @@ static int send_results_notification(const char *patient_id, int operation_id, i
         case SENT_BY_SURGERY:
             target_queue = mq_surgery_id;
             target_name = "Surgery";
-            
+
+            // Fast path: post straight into the SHM completion slot so the
+            // waiting surgery worker wakes without the dispatcher round-trip
+            completion_post_lab(operation_id, success);
+
             break;
 
         case SENT_BY_TRIAGE:
@@ -704,9 +759,7 @@ static void process_job(lab_job_t *job, int worker_id) {
     time_t completion_time = time(NULL);
     
     // Update turnaround time statistics
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->total_lab_turnaround_time += difftime(completion_time, actual_request_time);
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     if (!lab_should_shutdown()) {
         // Generate results file
@@ -735,18 +788,45 @@ static void* pool_worker_thread(void *arg) {
     snprintf(log_msg, sizeof(log_msg), "Worker %d started", worker_id);
     log_event(INFO, "LAB", "WORKER_START", log_msg);
     
+    // Home queue alternates across the pool so both labs keep dedicated
+    // workers; the other queue is the stealing target
+    int home = (worker_id - 1) % 2;
+    int other = 1 - home;
+
     while (1) {
-        // Pop a job from the queue (blocks until job available or shutdown)
-        lab_job_t *job = job_queue_pop(&job_queue);
-        
+        // Fast path: take from the home queue
+        lab_job_t *job = job_queue_try_pop(&lab_queues[home]);
+
+        // Home queue dry: steal only if the other lab is backed up past the
+        // watermark (unlocked depth read - it is just a heuristic)
+        if (job == NULL && lab_queues[other].count >= LAB_STEAL_WATERMARK) {
+            job = job_queue_try_pop(&lab_queues[other]);
+            #ifdef DEBUG
+                if (job != NULL) {
+                    char steal_msg[96];
+                    snprintf(steal_msg, sizeof(steal_msg), "Worker %d stole job for %s from queue %d",
+                             worker_id, job->patient_id, other + 1);
+                    log_event(DEBUG_LOG, "LAB", "JOB_STEAL", steal_msg);
+                }
+            #endif
+        }
+
+        // Nothing anywhere: block briefly on the home queue
         if (job == NULL) {
-            // Shutdown signaled - exit cleanly
-            break;
+            job = job_queue_pop(&lab_queues[home]);
         }
-        
+
+        if (job == NULL) {
+            if (lab_should_shutdown()) {
+                // Shutdown signaled - exit cleanly
+                break;
+            }
+            continue; // Timed out - re-check both queues
+        }
+
         // Process the job
         process_job(job, worker_id);
-        
+
         // Free the job
         free(job);
     }
@@ -761,64 +841,67 @@ static void* pool_worker_thread(void *arg) {
 // DISPATCHER LOOP
 // ============================================================================
 
+// Max lab requests drained from the MQ per wakeup
+#define LAB_DISPATCH_BATCH 32
+
 /**
  * Main dispatcher loop for the Laboratory Process
- * Receives MSG_LAB_REQUEST messages and pushes them to the job queue
+ * Drains MSG_LAB_REQUEST messages in batches and pushes them to the job queue
  * Exits when MSG_SHUTDOWN (poison pill) is received
  */
 static void dispatcher_loop(void) {
-    msg_lab_request_t request;
-    
+    static msg_lab_request_t batch[LAB_DISPATCH_BATCH];
+
     while (1) {
-        // Clear message buffer
-        memset(&request, 0, sizeof(request));
-        
-        // Receive next lab request (blocking with priority)
+        // Receive pending lab requests (blocks for the first, drains the rest)
         // Priority: URGENT (1) > NORMAL (3)
-        int rc = receive_generic_message(mq_lab_id, &request, sizeof(request), PRIORITY_NORMAL);
-        
-        if (rc != 0) {
+        int received = receive_message_drain(mq_lab_id, batch, sizeof(batch[0]),
+                                             LAB_DISPATCH_BATCH, PRIORITY_NORMAL);
+
+        if (received <= 0) {
             if (errno == EINTR) continue;  // Interrupted by signal
-            
+
             // Log error but continue
             char log_msg[64];
             snprintf(log_msg, sizeof(log_msg), "msgrcv error: %d", errno);
             log_event(WARNING, "LAB", "RECV_ERROR", log_msg);
             continue;
         }
-        
-        // Check for shutdown message (poison pill from manager)
-        if (request.hdr.kind == MSG_SHUTDOWN) {
-            log_event(INFO, "LAB", "SHUTDOWN_RECV", "Received shutdown signal");
-            break;
-        }
-        
-        // Validate message type
-        if (request.hdr.kind != MSG_LAB_REQUEST) {
-            char log_msg[64];
-            snprintf(log_msg, sizeof(log_msg), "Unexpected message kind: %d", request.hdr.kind);
-            log_event(WARNING, "LAB", "INVALID_MSG", log_msg);
-            continue;
-        }
-        
-        // Update statistics - track urgent lab tests
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-        if (request.hdr.mtype == PRIORITY_URGENT) {
-            shm_hospital->shm_stats->urgent_lab_tests++;
-        }
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
-        
-        // Log received request
-        char log_msg[128];
-        snprintf(log_msg, sizeof(log_msg), "Received lab request for %s (%d tests, op_id: %d)",
-                 request.hdr.patient_id, request.tests_count, request.hdr.operation_id);
-        log_event(INFO, "LAB", "REQUEST_RECV", log_msg);
-        
-        // Push to job queue for worker threads to process
-        if (job_queue_push(&job_queue, &request) != 0) {
-            log_event(ERROR, "LAB", "QUEUE_FAIL", "Failed to enqueue job");
-            // Send failure notification
-            send_results_notification(request.hdr.patient_id, request.hdr.operation_id, 0, request.sender);
+
+        for (int i = 0; i < received; i++) {
+            msg_lab_request_t *request = &batch[i];
+
+            // Check for shutdown message (poison pill from manager)
+            if (request->hdr.kind == MSG_SHUTDOWN) {
+                log_event(INFO, "LAB", "SHUTDOWN_RECV", "Received shutdown signal");
+                return;
+            }
+
+            // Validate message type
+            if (request->hdr.kind != MSG_LAB_REQUEST) {
+                char log_msg[64];
+                snprintf(log_msg, sizeof(log_msg), "Unexpected message kind: %d", request->hdr.kind);
+                log_event(WARNING, "LAB", "INVALID_MSG", log_msg);
+                continue;
+            }
+
+            // Update statistics - track urgent lab tests
+            if (request->hdr.mtype == PRIORITY_URGENT) {
+                shm_hospital->shm_stats->urgent_lab_tests++;
+            }
+
+            // Log received request
+            char log_msg[128];
+            snprintf(log_msg, sizeof(log_msg), "Received lab request for %s (%d tests, op_id: %d)",
+                     request->hdr.patient_id, request->tests_count, request->hdr.operation_id);
+            log_event(INFO, "LAB", "REQUEST_RECV", log_msg);
+
+            // Push to job queue for worker threads to process
+            if (job_queue_push(&lab_queues[classify_job_queue(request)], request) != 0) {
+                log_event(ERROR, "LAB", "QUEUE_FAIL", "Failed to enqueue job");
+                // Send failure notification
+                send_results_notification(request->hdr.patient_id, request->hdr.operation_id, 0, request->sender);
+            }
         }
     }
 }
@@ -837,9 +920,20 @@ void lab_main(void) {
     // Seed random number generator
     srand((unsigned int)(time(NULL) ^ getpid()));
     
-    // Initialize the job queue
-    job_queue_init(&job_queue);
-    
+    // Initialize the per-lab job queues
+    job_queue_init(&lab_queues[0]);
+    job_queue_init(&lab_queues[1]);
+
+    // Start the async results writer (journal or file-per-patient layout)
+    if (config->results_journal_mode) {
+        char journal_path[256];
+        snprintf(journal_path, sizeof(journal_path),
+                 "results/lab_results/journal_%ld.log", (long)time(NULL));
+        results_writer_init("LAB", journal_path);
+    } else {
+        results_writer_init("LAB", NULL);
+    }
+
     // Create the fixed thread pool
     pthread_t workers[LAB_POOL_SIZE];
     int workers_created = 0;
@@ -872,7 +966,8 @@ void lab_main(void) {
     
     if (workers_created == 0) {
         log_event(ERROR, "LAB", "POOL_FAIL", "No worker threads created, exiting");
-        job_queue_destroy(&job_queue);
+        job_queue_destroy(&lab_queues[0]);
+        job_queue_destroy(&lab_queues[1]);
         child_cleanup();
         exit(EXIT_FAILURE);
     }
@@ -890,7 +985,8 @@ void lab_main(void) {
     #endif
     
     // 1. Signal all workers to shutdown
-    job_queue_shutdown(&job_queue);
+    job_queue_shutdown(&lab_queues[0]);
+    job_queue_shutdown(&lab_queues[1]);
     
     // 2. Wait for all worker threads to join
     #ifdef DEBUG
@@ -907,8 +1003,10 @@ void lab_main(void) {
     
     log_event(INFO, "LAB", "WORKERS_JOINED", "All worker threads joined");
     
-    // 3. Cleanup the job queue
-    job_queue_destroy(&job_queue);
+    // 3. Flush pending results and cleanup the job queues
+    results_writer_destroy();
+    job_queue_destroy(&lab_queues[0]);
+    job_queue_destroy(&lab_queues[1]);
     
     #ifdef DEBUG
         log_event(DEBUG_LOG, "LAB", "CHILD_CLEANUP", "Calling child_cleanup");
@@ -3,21 +3,61 @@
 #include <time.h>
 #include <string.h>
 #include <pthread.h>
-// #include <stdarg.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <errno.h>
 
 #include "../include/log.h"
 #include "../include/safe_threads.h"
 
+// --- Batched logging backend ---
+//
+// log_event() no longer writes to the file directly: callers append a
+// fixed-size record into a per-process lock-free MPSC ring and a dedicated
+// writer thread drains the ring in batches (one writev per batch).
+// CRITICAL/ERROR records wake the writer immediately; everything else is
+// flushed on a periodic interval. The public API is unchanged.
 
-// Global log file pointer
-static FILE *log_file = NULL;
+#define LOG_RING_SIZE       1024    // Must be a power of two
+#define LOG_BATCH_MAX       100     // Records per writev
+#define LOG_FLUSH_INTERVAL_MS 50    // Periodic flush interval
+#define LOG_LINE_MAX        384     // Formatted line buffer per record
+
+// Fixed-size record stored in the ring (mirrors critical_event_t fields)
+typedef struct {
+    atomic_size_t seq;              // Vyukov-style slot sequence number
+    time_t timestamp;
+    log_severity_t severity;
+    char component[20];
+    char event_type[30];
+    char description[256];
+} log_record_t;
+
+// Global log file descriptor (O_APPEND so batches from different processes interleave whole)
+static int log_fd = -1;
 
 // SHM
 static critical_log_shm_t *global_log_shm = NULL;
 
-// Mutex
+// Mutex (protects init/close and the synchronous fallback path)
 pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// --- Ring state ---
+static log_record_t log_ring[LOG_RING_SIZE];
+static atomic_size_t ring_head;     // Next slot producers claim
+static atomic_size_t ring_tail;     // Next slot the writer drains (writer-only)
+static atomic_long dropped_records; // Records lost because the ring was full
+
+// --- Writer thread state ---
+static pthread_t writer_thread;
+static int writer_running = 0;
+static pid_t logger_pid = -1;       // Process that owns writer_thread (fork detection)
+static pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writer_cond = PTHREAD_COND_INITIALIZER;
+static int flush_requested = 0;
+
 // Map severity enum to string
 const char* get_severity_str(log_severity_t severity) {
     switch(severity) {
@@ -35,17 +75,265 @@ void set_critical_log_shm_ptr(critical_log_shm_t *shm_ptr) {
     global_log_shm = shm_ptr;
 }
 
+// --- Ring operations ---
+
+static void ring_reset(void) {
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+        atomic_store_explicit(&log_ring[i].seq, i, memory_order_relaxed);
+    }
+    atomic_store_explicit(&ring_head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring_tail, 0, memory_order_relaxed);
+}
+
+// Multi-producer enqueue. Returns 0 on success, -1 if the ring is full.
+static int ring_push(log_severity_t severity, const char *component,
+                     const char *event_type, const char *details, time_t now) {
+    size_t pos = atomic_load_explicit(&ring_head, memory_order_relaxed);
+
+    for (;;) {
+        log_record_t *slot = &log_ring[pos & (LOG_RING_SIZE - 1)];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            // Slot is free - try to claim it
+            if (atomic_compare_exchange_weak_explicit(&ring_head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                slot->timestamp = now;
+                slot->severity = severity;
+                snprintf(slot->component, sizeof(slot->component), "%s", component);
+                snprintf(slot->event_type, sizeof(slot->event_type), "%s", event_type);
+                snprintf(slot->description, sizeof(slot->description), "%s", details);
+
+                // Publish - the writer may now consume this slot
+                atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+                return 0;
+            }
+            // CAS failed: pos was refreshed, retry
+        } else if (diff < 0) {
+            return -1; // Ring full
+        } else {
+            pos = atomic_load_explicit(&ring_head, memory_order_relaxed);
+        }
+    }
+}
+
+// Single-consumer dequeue (writer thread only). Returns 0 on success, -1 if empty.
+static int ring_pop(log_record_t *out) {
+    size_t pos = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    log_record_t *slot = &log_ring[pos & (LOG_RING_SIZE - 1)];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    if ((intptr_t)seq - (intptr_t)(pos + 1) < 0) {
+        return -1; // Slot not published yet
+    }
+
+    out->timestamp = slot->timestamp;
+    out->severity = slot->severity;
+    memcpy(out->component, slot->component, sizeof(out->component));
+    memcpy(out->event_type, slot->event_type, sizeof(out->event_type));
+    memcpy(out->description, slot->description, sizeof(out->description));
+
+    // Free the slot for the producers one lap ahead
+    atomic_store_explicit(&slot->seq, pos + LOG_RING_SIZE, memory_order_release);
+    atomic_store_explicit(&ring_tail, pos + 1, memory_order_relaxed);
+    return 0;
+}
+
+// --- Record formatting ---
+
+static int format_record(const log_record_t *rec, char *line, size_t line_size) {
+    struct tm timeinfo;
+    char timestamp[25];
+
+    if (localtime_r(&rec->timestamp, &timeinfo) != NULL) {
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    } else {
+        strncpy(timestamp, "UNKNOWN", sizeof(timestamp));
+    }
+
+    // Format: [TIMESTAMP] [COMPONENT] [SEVERITY] [EVENT_TYPE] details
+    int len = snprintf(line, line_size, "[%s] [%s] [%s] [%s] %s\n",
+                       timestamp,
+                       rec->component,
+                       get_severity_str(rec->severity),
+                       rec->event_type,
+                       rec->description);
+    if (len < 0) return 0;
+    if ((size_t)len >= line_size) len = (int)line_size - 1;
+    return len;
+}
+
+// Write to Shared Memory (critical events circular buffer)
+static void write_critical_shm(const log_record_t *rec) {
+    if (global_log_shm == NULL) return;
+
+    safe_pthread_mutex_lock(&global_log_shm->mutex);
+
+    int idx = global_log_shm->current_index;
+
+    global_log_shm->events[idx].timestamp = rec->timestamp;
+    global_log_shm->events[idx].severity = rec->severity;
+
+    snprintf(global_log_shm->events[idx].event_type,
+             sizeof(global_log_shm->events[idx].event_type),
+             "%s", rec->event_type);
+
+    snprintf(global_log_shm->events[idx].component,
+             sizeof(global_log_shm->events[idx].component),
+             "%s", rec->component);
+
+    snprintf(global_log_shm->events[idx].description,
+             sizeof(global_log_shm->events[idx].description),
+             "%s", rec->description);
+
+    // Move index forward, wrapping around at 1000
+    global_log_shm->current_index = (idx + 1) % 1000;
+
+    // Track total count up to the maximum capacity (stops at 1000)
+    if (global_log_shm->event_count < 1000) {
+        global_log_shm->event_count++;
+    }
+
+    safe_pthread_mutex_unlock(&global_log_shm->mutex);
+}
+
+// Should this record also be mirrored to the SHM critical buffer?
+static int is_critical_record(const log_record_t *rec) {
+    return rec->severity <= ERROR || strcmp(rec->event_type, "SHUTDOWN") == 0;
+}
+
+// --- Writer thread ---
+
+// Drain up to LOG_BATCH_MAX records and write them with a single writev
+static int drain_batch(void) {
+    static log_record_t batch[LOG_BATCH_MAX];
+    static char lines[LOG_BATCH_MAX][LOG_LINE_MAX];
+    struct iovec iov[LOG_BATCH_MAX];
+    int count = 0;
+
+    while (count < LOG_BATCH_MAX && ring_pop(&batch[count]) == 0) {
+        iov[count].iov_base = lines[count];
+        iov[count].iov_len = format_record(&batch[count], lines[count], LOG_LINE_MAX);
+        count++;
+    }
+
+    if (count == 0) return 0;
+
+    if (log_fd != -1) {
+        ssize_t written;
+        do {
+            written = writev(log_fd, iov, count);
+        } while (written == -1 && errno == EINTR);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (is_critical_record(&batch[i])) {
+            write_critical_shm(&batch[i]);
+        }
+
+        // Console Output for Debugging
+        #ifdef DEBUG
+            fwrite(lines[i], 1, iov[i].iov_len, stdout);
+        #endif
+    }
+
+    return count;
+}
+
+static void *log_writer_main(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&writer_mutex);
+    while (writer_running) {
+        if (!flush_requested) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += (long)LOG_FLUSH_INTERVAL_MS * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec += 1;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&writer_cond, &writer_mutex, &ts);
+        }
+        flush_requested = 0;
+        pthread_mutex_unlock(&writer_mutex);
+
+        // Drain everything currently in the ring
+        while (drain_batch() == LOG_BATCH_MAX)
+            ;
+
+        pthread_mutex_lock(&writer_mutex);
+    }
+    pthread_mutex_unlock(&writer_mutex);
+
+    // Final drain so no record is lost on shutdown
+    while (drain_batch() > 0)
+        ;
+
+    return NULL;
+}
+
+// Wake the writer thread (severity-triggered or batch-threshold flush)
+static void request_flush(void) {
+    pthread_mutex_lock(&writer_mutex);
+    flush_requested = 1;
+    pthread_cond_signal(&writer_cond);
+    pthread_mutex_unlock(&writer_mutex);
+}
+
+// Start the writer thread for the current process (caller holds log_mutex)
+static int start_writer_locked(void) {
+    writer_running = 1;
+    if (pthread_create(&writer_thread, NULL, log_writer_main, NULL) != 0) {
+        writer_running = 0;
+        return -1;
+    }
+    logger_pid = getpid();
+    return 0;
+}
+
+// After fork() the child inherits the ring but not the writer thread.
+// Reset the ring (the parent's writer owns the pending records) and
+// spawn a fresh writer for this process.
+static void reinit_after_fork(void) {
+    pthread_mutex_lock(&log_mutex);
+    if (logger_pid != getpid() && log_fd != -1) {
+        ring_reset();
+        pthread_mutex_init(&writer_mutex, NULL);
+        pthread_cond_init(&writer_cond, NULL);
+        flush_requested = 0;
+        start_writer_locked();
+    }
+    pthread_mutex_unlock(&log_mutex);
+}
+
+// --- Public API ---
+
 // Initialize logging system
 int init_logging(const char *filepath) {
     pthread_mutex_lock(&log_mutex);
 
     // Open in append mode
-    log_file = fopen(filepath, "a");
-    if (!log_file) {
+    log_fd = open(filepath, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (log_fd == -1) {
         perror("Failed to open log file");
         pthread_mutex_unlock(&log_mutex);
         return -1;
     }
+
+    ring_reset();
+    atomic_store(&dropped_records, 0);
+
+    if (start_writer_locked() != 0) {
+        perror("Failed to start log writer thread");
+        close(log_fd);
+        log_fd = -1;
+        pthread_mutex_unlock(&log_mutex);
+        return -1;
+    }
+
     pthread_mutex_unlock(&log_mutex);
     return 0;
 }
@@ -53,98 +341,81 @@ int init_logging(const char *filepath) {
 // Close logging system
 void close_logging() {
     pthread_mutex_lock(&log_mutex);
-    if (log_file) {
-        fclose(log_file);
-        log_file = NULL;
+
+    if (writer_running && logger_pid == getpid()) {
+        pthread_mutex_lock(&writer_mutex);
+        writer_running = 0;
+        flush_requested = 1;
+        pthread_cond_signal(&writer_cond);
+        pthread_mutex_unlock(&writer_mutex);
+        pthread_join(writer_thread, NULL);
+    }
+    writer_running = 0;
+
+    long dropped = atomic_load(&dropped_records);
+    if (log_fd != -1 && dropped > 0) {
+        char line[128];
+        int len = snprintf(line, sizeof(line),
+                           "[LOG] %ld record(s) dropped (ring full)\n", dropped);
+        if (len > 0) {
+            ssize_t w = write(log_fd, line, (size_t)len);
+            (void)w;
+        }
+    }
+
+    if (log_fd != -1) {
+        close(log_fd);
+        log_fd = -1;
     }
     global_log_shm = NULL;
     pthread_mutex_unlock(&log_mutex);
 }
 
-// Log events 
+// Log events
 void log_event(log_severity_t severity, const char *component, const char *event_type, const char *details) {
-    // Prepare Timestamp
     time_t now;
-    struct tm *timeinfo;
-    char timestamp[25];
     time(&now);
-    timeinfo = localtime(&now);
 
-    if (timeinfo != NULL) {
-        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", timeinfo);
-    } else {
-        strncpy(timestamp, "UNKNOWN", sizeof(timestamp));
+    if (log_fd == -1) {
+        // Fallback if file is closed/failed
+        fprintf(stderr, "[LOG ERROR] System not initialized. Event: %s | %s\n", event_type, details);
+        return;
     }
 
-    // Lock Local Mutex
-    pthread_mutex_lock(&log_mutex);
+    // Forked children inherit the ring but not the writer thread
+    if (logger_pid != getpid()) {
+        reinit_after_fork();
+    }
 
-    if (!log_file) {
-        // Fallback if file is closed/failed
-        fprintf(stderr, "[LOG ERROR] System not initialized. Event: %s | %s\n", event_type, details);
-    } else {
-        // Format: [TIMESTAMP] [COMPONENT] [SEVERITY] [EVENT_TYPE] details
-        fprintf(log_file, "[%s] [%s] [%s] [%s] %s\n", 
-                timestamp, 
-                component, 
-                get_severity_str(severity), 
-                event_type, 
-                details);
-        
-        // Flush immediately to ensure data is written
-        fflush(log_file);
-    }
-
-    // Write to Shared Memory (Critical Logic)
-    // Only write to SHM if severity is high or it's a shutdown event
-    if (severity <= ERROR || (event_type && strcmp(event_type, "SHUTDOWN") == 0)) {
-        if (global_log_shm != NULL) {
-            // Lock SHM Mutex
-            safe_pthread_mutex_lock(&global_log_shm->mutex);
-            
-            int idx = global_log_shm->current_index;
-            
-            // Write Data to SHM Struct
-            
-            // Timestamp 
-            global_log_shm->events[idx].timestamp = now;
-            
-            // Severity
-            global_log_shm->events[idx].severity = severity;
-            
-            // Strings
-            snprintf(global_log_shm->events[idx].event_type, 
-                     sizeof(global_log_shm->events[idx].event_type), 
-                     "%s", event_type);
-
-            snprintf(global_log_shm->events[idx].component, 
-                     sizeof(global_log_shm->events[idx].component), 
-                     "%s", component);
-
-            snprintf(global_log_shm->events[idx].description, 
-                     sizeof(global_log_shm->events[idx].description), 
-                     "%s", details);
-
-            // --- Circular Buffer Update ---
-            
-            // Move index forward, wrapping around at 1000
-            global_log_shm->current_index = (idx + 1) % 1000;
-
-            // Track total count up to the maximum capacity (stops at 1000)
-            if (global_log_shm->event_count < 1000) {
-                global_log_shm->event_count++;
-            }
-            
-            safe_pthread_mutex_unlock(&global_log_shm->mutex);
+    if (ring_push(severity, component, event_type, details, now) == -1) {
+        // Ring full: never lose critical/error records - write them synchronously
+        if (severity <= ERROR) {
+            log_record_t rec;
+            char line[LOG_LINE_MAX];
+            rec.timestamp = now;
+            rec.severity = severity;
+            snprintf(rec.component, sizeof(rec.component), "%s", component);
+            snprintf(rec.event_type, sizeof(rec.event_type), "%s", event_type);
+            snprintf(rec.description, sizeof(rec.description), "%s", details);
+
+            int len = format_record(&rec, line, sizeof(line));
+            pthread_mutex_lock(&log_mutex);
+            ssize_t w = write(log_fd, line, (size_t)len);
+            (void)w;
+            pthread_mutex_unlock(&log_mutex);
+            write_critical_shm(&rec);
+        } else {
+            atomic_fetch_add(&dropped_records, 1);
         }
+        request_flush();
+        return;
     }
 
-    // Console Output for Debugging
-    #ifdef DEBUG
-        printf("[%s] [%s] [%s] [%s] %s\n", 
-            timestamp, component, get_severity_str(severity), event_type, details);
-    #endif
-
-    pthread_mutex_unlock(&log_mutex);
+    // Severity-triggered flush: urgent records don't wait for the interval.
+    // Also wake the writer when a full batch has accumulated.
+    size_t pending = atomic_load_explicit(&ring_head, memory_order_relaxed) -
+                     atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    if (severity <= ERROR || pending >= LOG_BATCH_MAX) {
+        request_flush();
+    }
 }
-
@@ -27,6 +27,7 @@
 #include "../include/dispatcher.h"
 #include "../include/command_handler.h"
 #include "../include/manager_utils.h"
+#include "../include/time_simulation.h"
 
 // --- FILE PATHS ---
 
@@ -411,10 +412,8 @@ int main(void) {
             current_logical_time += ticks_passed;
             accumulated_ms %= config->time_unit_ms;
 
-            // Update global clock time
-            safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-            shm_hospital->shm_stats->simulation_time_units = current_logical_time;
-            safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
+            // Update global clock time (wakes any virtual-time waiters)
+            vt_publish_time(current_logical_time);
 
             #ifdef DEBUG
                 char tick_msg[50];
@@ -429,6 +428,36 @@ int main(void) {
             break;
         }
 
+        // Virtual time: select() timed out with nothing due and no fd activity,
+        // so every process is blocked waiting on the clock - jump it straight
+        // to the next interesting instant (next scheduled event or earliest
+        // registered sleeper deadline) instead of burning wall time on ticks.
+        if (config->virtual_time_enabled && ret == 0) {
+            int next_event = has_scheduled_events() ? get_next_scheduled_time() : -1;
+            int next_wake = vt_earliest_deadline();
+
+            if (next_event == -1 || next_event > current_logical_time) {
+                int jump_to = -1;
+                if (next_event > current_logical_time) jump_to = next_event;
+                if (next_wake > current_logical_time &&
+                    (jump_to == -1 || next_wake < jump_to)) {
+                    jump_to = next_wake;
+                }
+
+                if (jump_to > current_logical_time) {
+                    current_logical_time = jump_to;
+                    accumulated_ms = 0;
+                    vt_publish_time(current_logical_time);
+
+                    #ifdef DEBUG
+                        char jump_msg[60];
+                        snprintf(jump_msg, sizeof(jump_msg), "Clock jumped to: %d", current_logical_time);
+                        log_event(DEBUG_LOG, "SCHEDULER", "VT_JUMP", jump_msg);
+                    #endif
+                }
+            }
+        }
+
         // 4. Process Due Events
         process_scheduled_events(current_logical_time);
 
@@ -209,6 +209,36 @@ int send_generic_message(int mq_id, const void *msg_ptr, size_t total_struct_siz
     return 0;
 }
 
+/**
+ * Sends a batch of messages to a MQ in one call.
+ * Each message is tried with IPC_NOWAIT first so a burst does not stall
+ * mid-way; only when the queue is full does the send fall back to blocking.
+ * @param mq_id Destin's Q ID
+ * @param msgs Array of message descriptors (ptr + sizeof of each struct)
+ * @param count Number of messages in the array
+ * @return Number of messages sent (count on full success)
+ */
+int send_message_batch(int mq_id, const mq_batch_msg_t *msgs, int count) {
+    int sent = 0;
+
+    for (int i = 0; i < count; i++) {
+        size_t payload_size = MSG_SIZE_CALC(msgs[i].total_struct_size);
+
+        if (msgsnd(mq_id, msgs[i].msg_ptr, payload_size, IPC_NOWAIT) == -1) {
+            if (errno != EAGAIN ||
+                msgsnd(mq_id, msgs[i].msg_ptr, payload_size, 0) == -1) {
+                char desc[128];
+                snprintf(desc, sizeof(desc), "Failed to send batch message %d/%d (PID: %d)",
+                         i + 1, count, getpid());
+                log_event(ERROR, "IPC", "MSG_FAIL", desc);
+                continue;
+            }
+        }
+        sent++;
+    }
+    return sent;
+}
+
 /**
  * Receives a message from a Message Queue with priority support.
  * @param mq_id Queue ID.
@@ -242,6 +272,49 @@ int receive_generic_message(int mq_id, void *msg_buffer, size_t total_struct_siz
     return 0;
 }
 
+/**
+ * Receives a burst of messages from a Message Queue with priority support.
+ * Blocks for the first message, then drains everything already pending with
+ * IPC_NOWAIT - so a burst released at the same tick is moved with one call
+ * per consumer wakeup instead of one syscall round-trip per message.
+ * @param mq_id Queue ID.
+ * @param msg_array Array of max_count message structs (all the same type).
+ * @param total_struct_size sizeof(MESSAGE_TYPE) - the array element stride.
+ * @param max_count Capacity of msg_array.
+ * @param max_priority_type The maximum message type (mtype) to accept.
+ * @return Number of messages received (>= 1), or -1 on failure.
+ */
+int receive_message_drain(int mq_id, void *msg_array, size_t total_struct_size, int max_count, long max_priority_type) {
+    size_t payload_size = MSG_SIZE_CALC(total_struct_size);
+    long msgtyp_priority = MAX_PRIORITY_TO_ACCEPT(max_priority_type);
+    char *base = (char *)msg_array;
+
+    // First message: blocking (same semantics as receive_generic_message)
+    ssize_t result = msgrcv(mq_id, base, payload_size, msgtyp_priority, 0);
+    if (result == -1) {
+        // EIDRM: message queue was removed - trigger graceful shutdown
+        if (errno == EIDRM) {
+            set_shutdown();
+            return -1;
+        }
+        // EINTR: signal interruption - not an error
+        if (errno != EINTR) {
+            log_event(ERROR, "IPC", "MSG_FAIL", "Failed to receive message");
+        }
+        return -1;
+    }
+
+    // Drain whatever else is already pending without blocking
+    int count = 1;
+    while (count < max_count) {
+        result = msgrcv(mq_id, base + (size_t)count * total_struct_size,
+                        payload_size, msgtyp_priority, IPC_NOWAIT);
+        if (result == -1) break; // ENOMSG: queue drained
+        count++;
+    }
+    return count;
+}
+
 /**
  * Receives a specific message type from a Message Queue.
  * @param mq_id Queue ID.
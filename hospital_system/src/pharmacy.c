@@ -21,6 +21,8 @@
 #include "../include/time_simulation.h"
 #include "../include/manager_utils.h"
 #include "../include/pipes.h"
+#include "../include/results_writer.h"
+#include "../include/completion.h"
 
 // --- Constants ---
 #define MAX_CONCURRENT_REQUESTS 200
@@ -78,44 +80,113 @@ static int release_pharmacy_access(void) {
     return sem_post_safe(sem_pharmacy, "PHARMACY_ACCESS");
 }
 
+// Largest meds_id[] array in any request message (msg_pharmacy_request_t)
+#define PHARM_BATCH_MAX 8
+
 /**
- * Check stock availability for all medications in request
- * @return 1 if all items available, 0 otherwise
+ * All-or-nothing batch reservation
+ * Acquires the per-med mutexes in ascending med_id order (deadlock-free
+ * against any concurrent batch), checks the whole set under the locks and
+ * commits the reservation atomically. On shortage nothing is reserved and
+ * shortfall[i] receives the missing quantity for each request item, so the
+ * caller can trigger restock without re-scanning the stock.
+ * @return 0 on success, number of short items on shortage, -1 on invalid id
  */
-static int check_stock_availability(int *meds_id, int *meds_qty, int meds_count) {
+static int reserve_batch(int *meds_id, int *meds_qty, int meds_count, int *shortfall) {
+    if (meds_count <= 0 || meds_count > PHARM_BATCH_MAX) return -1;
+
+    // Sort item indexes by med_id to fix the global lock order
+    int order[PHARM_BATCH_MAX];
     for (int i = 0; i < meds_count; i++) {
+        if (meds_id[i] < 0 || meds_id[i] >= config->med_count) return -1;
+        order[i] = i;
+        shortfall[i] = 0;
+    }
+    for (int i = 1; i < meds_count; i++) {
+        int tmp = order[i];
+        int j = i - 1;
+        while (j >= 0 && meds_id[order[j]] > meds_id[tmp]) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = tmp;
+    }
+
+    // Lock ascending, once per distinct med
+    int last_id = -1;
+    for (int k = 0; k < meds_count; k++) {
+        int med_id = meds_id[order[k]];
+        if (med_id != last_id) {
+            safe_pthread_mutex_lock(&shm_hospital->shm_pharm->medications[med_id].mutex);
+            last_id = med_id;
+        }
+    }
+
+    // Check the whole set (duplicates of a med share its availability)
+    int short_items = 0;
+    int avail_left = 0;
+    last_id = -1;
+    for (int k = 0; k < meds_count; k++) {
+        int i = order[k];
         int med_id = meds_id[i];
-        int qty_needed = meds_qty[i];
-        
-        if (med_id < 0 || med_id >= config->med_count) {
-            return 0;  // Invalid medication
+        if (med_id != last_id) {
+            avail_left = shm_hospital->shm_pharm->medications[med_id].current_stock -
+                         shm_hospital->shm_pharm->medications[med_id].reserved;
+            last_id = med_id;
         }
-        
-        safe_pthread_mutex_lock(&shm_hospital->shm_pharm->medications[med_id].mutex);
-        int available = shm_hospital->shm_pharm->medications[med_id].current_stock - 
-                       shm_hospital->shm_pharm->medications[med_id].reserved;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->medications[med_id].mutex);
-        
-        if (available < qty_needed) {
-            return 0;  // Not enough stock
+        if (avail_left < meds_qty[i]) {
+            shortfall[i] = meds_qty[i] - (avail_left > 0 ? avail_left : 0);
+            short_items++;
+            avail_left = 0;
+        } else {
+            avail_left -= meds_qty[i];
+        }
+    }
+
+    // Commit only if every item fits
+    if (short_items == 0) {
+        for (int i = 0; i < meds_count; i++) {
+            shm_hospital->shm_pharm->medications[meds_id[i]].reserved += meds_qty[i];
+        }
+    }
+
+    // Unlock descending (reverse of acquisition order)
+    last_id = -1;
+    for (int k = meds_count - 1; k >= 0; k--) {
+        int med_id = meds_id[order[k]];
+        if (med_id != last_id) {
+            safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->medications[med_id].mutex);
+            last_id = med_id;
         }
     }
-    return 1;
+
+    return short_items;
 }
 
 /**
- * Reserve stock for a request (to prevent race conditions)
+ * Restock exactly the meds a failed batch was short of (no full re-scan)
+ * Restock amount is the usual threshold * multiplier, bumped up if that
+ * still would not cover the shortfall.
  */
-static int reserve_stock(int *meds_id, int *meds_qty, int meds_count) {
+static void restock_shortfall(int *meds_id, int *shortfall, int meds_count) {
     for (int i = 0; i < meds_count; i++) {
+        if (shortfall[i] <= 0) continue;
         int med_id = meds_id[i];
-        int qty = meds_qty[i];
-        
+
         safe_pthread_mutex_lock(&shm_hospital->shm_pharm->medications[med_id].mutex);
-        shm_hospital->shm_pharm->medications[med_id].reserved += qty;
+        int restock_amount = shm_hospital->shm_pharm->medications[med_id].threshold *
+                             config->restock_qty_multiplier;
+        if (restock_amount < shortfall[i]) restock_amount = shortfall[i];
+        shm_hospital->shm_pharm->medications[med_id].current_stock += restock_amount;
         safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->medications[med_id].mutex);
+
+        shm_hospital->shm_stats->auto_restocks++;
+
+        char log_msg[128];
+        snprintf(log_msg, sizeof(log_msg), "Auto-restocked %s with %d units (shortfall)",
+                get_med_name(med_id), restock_amount);
+        log_event(INFO, "PHARMACY", "AUTO_RESTOCK", log_msg);
     }
-    return 0;
 }
 
 /**
@@ -134,9 +205,7 @@ static int dispense_medications(int *meds_id, int *meds_qty, int meds_count) {
         
         // Check for stock depletion
         if (shm_hospital->shm_pharm->medications[med_id].current_stock == 0) {
-            safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
             shm_hospital->shm_stats->stock_depletions++;
-            safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
             
             char log_msg[128];
             snprintf(log_msg, sizeof(log_msg), "Stock depleted for %s", get_med_name(med_id));
@@ -152,9 +221,7 @@ static int dispense_medications(int *meds_id, int *meds_qty, int meds_count) {
                                 config->restock_qty_multiplier;
             shm_hospital->shm_pharm->medications[med_id].current_stock += restock_amount;
             
-            safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
             shm_hospital->shm_stats->auto_restocks++;
-            safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
             
             char log_msg[128];
             snprintf(log_msg, sizeof(log_msg), "Auto-restocked %s with %d units", 
@@ -165,9 +232,7 @@ static int dispense_medications(int *meds_id, int *meds_qty, int meds_count) {
         safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->medications[med_id].mutex);
         
         // Update medication usage stats
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         shm_hospital->shm_stats->medication_usage[med_id] += qty;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     }
     return 0;
 }
@@ -192,49 +257,53 @@ static void release_reservation(int *meds_id, int *meds_qty, int meds_count) {
 static int write_delivery_file(const char *patient_id, int *meds_id, int *meds_qty, 
                                 int meds_count, time_t request_time, time_t completion_time) {
     char filepath[256];
-    snprintf(filepath, sizeof(filepath), "results/pharmacy_deliveries/%s_%ld.txt", 
+    snprintf(filepath, sizeof(filepath), "results/pharmacy_deliveries/%s_%ld.txt",
              patient_id, (long)completion_time);
-    
-    FILE *fp = fopen(filepath, "w");
-    if (!fp) {
-        char log_msg[512];
-        snprintf(log_msg, sizeof(log_msg), "Failed to create delivery file: %s", filepath);
-        log_event(ERROR, "PHARMACY", "FILE_ERROR", log_msg);
-        return -1;
-    }
-    
+
     // Use thread-safe ctime_r() instead of ctime() to avoid race condition
     // on the static buffer used by ctime()/asctime()
     char request_time_str[26];
     char completion_time_str[26];
     ctime_r(&request_time, request_time_str);
     ctime_r(&completion_time, completion_time_str);
-    
-    fprintf(fp, "============================================\n");
-    fprintf(fp, "       PHARMACY DELIVERY RECORD\n");
-    fprintf(fp, "============================================\n\n");
-    fprintf(fp, "Patient/Request ID: %s\n", patient_id);
-    fprintf(fp, "Request Time:       %s", request_time_str);
-    fprintf(fp, "Delivery Time:      %s", completion_time_str);
-    fprintf(fp, "Items Delivered:    %d\n\n", meds_count);
-    fprintf(fp, "--------------------------------------------\n");
-    fprintf(fp, "              MEDICATIONS\n");
-    fprintf(fp, "--------------------------------------------\n\n");
-    
-    for (int i = 0; i < meds_count; i++) {
-        fprintf(fp, "  %-20s  x%d\n", get_med_name(meds_id[i]), meds_qty[i]);
+
+    // Format in memory, enqueue for the async writer (no disk I/O here)
+    char record[RW_CONTENT_MAX];
+    size_t off = 0;
+
+    off += snprintf(record + off, sizeof(record) - off,
+        "============================================\n"
+        "       PHARMACY DELIVERY RECORD\n"
+        "============================================\n\n"
+        "Patient/Request ID: %s\n"
+        "Request Time:       %s"
+        "Delivery Time:      %s"
+        "Items Delivered:    %d\n\n"
+        "--------------------------------------------\n"
+        "              MEDICATIONS\n"
+        "--------------------------------------------\n\n",
+        patient_id, request_time_str, completion_time_str, meds_count);
+
+    for (int i = 0; i < meds_count && off < sizeof(record); i++) {
+        off += snprintf(record + off, sizeof(record) - off,
+            "  %-20s  x%d\n", get_med_name(meds_id[i]), meds_qty[i]);
     }
-    
-    fprintf(fp, "\n--------------------------------------------\n");
-    fprintf(fp, "Delivery confirmed by Hospital Pharmacy\n");
-    fprintf(fp, "============================================\n");
-    
-    fclose(fp);
-    
+
+    if (off < sizeof(record)) {
+        off += snprintf(record + off, sizeof(record) - off,
+            "\n--------------------------------------------\n"
+            "Delivery confirmed by Hospital Pharmacy\n"
+            "============================================\n");
+    }
+
+    if (results_writer_enqueue(filepath, patient_id, record) != 0) {
+        return -1;
+    }
+
     char log_msg[512];
-    snprintf(log_msg, sizeof(log_msg), "Delivery file created: %s", filepath);
+    snprintf(log_msg, sizeof(log_msg), "Delivery queued: %s", filepath);
     log_event(INFO, "PHARMACY", "DELIVERY_FILE", log_msg);
-    
+
     return 0;
 }
 
@@ -274,6 +343,11 @@ static int send_pharmacy_notification(const char *patient_id, int operation_id,
         case SENT_BY_SURGERY:
             target_queue = mq_surgery_id;
             target_name = "Surgery";
+
+            // Fast path: post straight into the SHM completion slot so the
+            // waiting surgery worker wakes without the dispatcher round-trip
+            completion_post_pharm(operation_id, success);
+
             break;
             
         case SENT_BY_TRIAGE:
@@ -346,11 +420,16 @@ static void* pharmacy_worker_thread(void *arg) {
         goto cleanup;
     }
     
-    // Check stock availability
-    if (check_stock_availability(args->meds_id, args->meds_qty, args->meds_count)) {
-        // Reserve stock
-        reserve_stock(args->meds_id, args->meds_qty, args->meds_count);
-        
+    // Reserve the whole order atomically; on shortage restock exactly the
+    // missing meds (if enabled) and retry once
+    int shortfall[PHARM_BATCH_MAX];
+    int short_items = reserve_batch(args->meds_id, args->meds_qty, args->meds_count, shortfall);
+    if (short_items > 0 && config->auto_restock_enabled) {
+        restock_shortfall(args->meds_id, shortfall, args->meds_count);
+        short_items = reserve_batch(args->meds_id, args->meds_qty, args->meds_count, shortfall);
+    }
+
+    if (short_items == 0) {
         // Release semaphore during preparation time (other requests can check stock)
         release_pharmacy_access();
         
@@ -383,9 +462,7 @@ static void* pharmacy_worker_thread(void *arg) {
         dispense_medications(args->meds_id, args->meds_qty, args->meds_count);
         
         // Update response time stats
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         shm_hospital->shm_stats->total_pharmacy_response_time += (end_time - start_time);
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
         
         release_pharmacy_access();
         
@@ -396,11 +473,11 @@ static void* pharmacy_worker_thread(void *arg) {
         log_event(INFO, "PHARMACY", "PREP_COMPLETE", log_msg);
         
     } else {
-        // Insufficient stock
+        // Insufficient stock (or invalid medication id)
         release_pharmacy_access();
-        
-        snprintf(log_msg, sizeof(log_msg), "Insufficient stock for %s request",
-                args->patient_id);
+
+        snprintf(log_msg, sizeof(log_msg), "Insufficient stock for %s request (%d items short)",
+                args->patient_id, short_items > 0 ? short_items : 0);
         log_event(WARNING, "PHARMACY", "STOCK_INSUFFICIENT", log_msg);
     }
     
@@ -527,9 +604,7 @@ static void handle_restock(msg_restock_t *restock) {
     safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->medications[med_id].mutex);
     
     // Update manual restock stats
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->manual_restocks++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     char log_msg[128];
     snprintf(log_msg, sizeof(log_msg), "Restocked %s with %d units", 
@@ -537,90 +612,95 @@ static void handle_restock(msg_restock_t *restock) {
     log_event(INFO, "PHARMACY", "RESTOCK_COMPLETE", log_msg);
 }
 
+// Max pharmacy messages drained from the MQ per wakeup
+#define PHARM_DISPATCH_BATCH 32
+
+// Union to receive different message types with proper alignment
+typedef union {
+    msg_pharmacy_request_t pharmacy_req;
+    msg_restock_t restock;
+    msg_header_t hdr;  // For checking message kind
+} pharmacy_msg_buf_t;
+
 /**
  * Main dispatcher loop for the Pharmacy Process
- * Receives MSG_PHARMACY_REQUEST and MSG_RESTOCK messages
+ * Drains MSG_PHARMACY_REQUEST and MSG_RESTOCK messages in batches
  * Handles priority: URGENT (1) > HIGH (2) > NORMAL (3)
  */
 static void process_pharmacy_requests(void) {
-    // Use a union to receive different message types with proper alignment
-    union {
-        msg_pharmacy_request_t pharmacy_req;
-        msg_restock_t restock;
-        msg_header_t hdr;  // For checking message kind
-    } msg_buf;
-    
+    static pharmacy_msg_buf_t batch[PHARM_DISPATCH_BATCH];
+
     while (!check_shutdown()) {
-        // Clear message buffer
-        memset(&msg_buf, 0, sizeof(msg_buf));
-        
-        // Receive next pharmacy message (blocking with priority)
+        // Receive pending messages (blocks for the first, drains the rest)
         // Using MAX_PRIORITY_TO_ACCEPT: URGENT(1) > HIGH(2) > NORMAL(3)
-        int rc = receive_generic_message(mq_pharmacy_id, &msg_buf, sizeof(msg_buf), PRIORITY_NORMAL);
-        
-        if (rc != 0) {
+        int received = receive_message_drain(mq_pharmacy_id, batch, sizeof(batch[0]),
+                                             PHARM_DISPATCH_BATCH, PRIORITY_NORMAL);
+
+        if (received <= 0) {
             if (check_shutdown()) break;
             if (errno == EINTR) continue;  // Interrupted by signal
-            
+
             // Log error but continue
             char log_msg[64];
             snprintf(log_msg, sizeof(log_msg), "msgrcv error: %d", errno);
             log_event(WARNING, "PHARMACY", "RECV_ERROR", log_msg);
             continue;
         }
-        
-        // Check for shutdown message
-        if (msg_buf.hdr.kind == MSG_SHUTDOWN) {
-            log_event(INFO, "PHARMACY", "SHUTDOWN_RECV", "Received shutdown signal");
-            set_shutdown();  // Set flag so workers can check it
-            break;
-        }
-        
-        // Handle restock messages
-        if (msg_buf.hdr.kind == MSG_RESTOCK) {
-            handle_restock(&msg_buf.restock);
-            continue;
-        }
-        
-        // Validate message type for pharmacy requests
-        if (msg_buf.hdr.kind != MSG_PHARMACY_REQUEST) {
-            char log_msg[64];
-            snprintf(log_msg, sizeof(log_msg), "Unexpected message kind: %d", msg_buf.hdr.kind);
-            log_event(WARNING, "PHARMACY", "INVALID_MSG", log_msg);
-            continue;
-        }
-        
-        msg_pharmacy_request_t *request = &msg_buf.pharmacy_req;
-        
-        // Update statistics based on priority
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-        shm_hospital->shm_stats->total_pharmacy_requests++;
-        if (request->hdr.mtype == PRIORITY_URGENT) {
-            shm_hospital->shm_stats->urgent_requests++;
-        } else {
-            shm_hospital->shm_stats->normal_requests++;
-        }
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
-        
-        // Update active requests in pharmacy SHM
-        safe_pthread_mutex_lock(&shm_hospital->shm_pharm->global_mutex);
-        shm_hospital->shm_pharm->total_active_requests++;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->global_mutex);
-        
-        // Log received request
-        char log_msg[128];
-        snprintf(log_msg, sizeof(log_msg), "Received pharmacy request for %s (%d items, op_id: %d, priority: %ld)",
-                 request->hdr.patient_id, request->meds_count, request->hdr.operation_id, request->hdr.mtype);
-        log_event(INFO, "PHARMACY", "REQUEST_RECV", log_msg);
-        
-        // Spawn worker thread to handle this request
-        if (spawn_worker(request) != 0) {
-            log_event(ERROR, "PHARMACY", "SPAWN_FAIL", "Failed to spawn worker for request");
-            
-            // Decrement active requests on failure
+
+        for (int i = 0; i < received; i++) {
+            pharmacy_msg_buf_t *msg_buf = &batch[i];
+
+            // Check for shutdown message
+            if (msg_buf->hdr.kind == MSG_SHUTDOWN) {
+                log_event(INFO, "PHARMACY", "SHUTDOWN_RECV", "Received shutdown signal");
+                set_shutdown();  // Set flag so workers can check it
+                return;
+            }
+
+            // Handle restock messages
+            if (msg_buf->hdr.kind == MSG_RESTOCK) {
+                handle_restock(&msg_buf->restock);
+                continue;
+            }
+
+            // Validate message type for pharmacy requests
+            if (msg_buf->hdr.kind != MSG_PHARMACY_REQUEST) {
+                char log_msg[64];
+                snprintf(log_msg, sizeof(log_msg), "Unexpected message kind: %d", msg_buf->hdr.kind);
+                log_event(WARNING, "PHARMACY", "INVALID_MSG", log_msg);
+                continue;
+            }
+
+            msg_pharmacy_request_t *request = &msg_buf->pharmacy_req;
+
+            // Update statistics based on priority
+            shm_hospital->shm_stats->total_pharmacy_requests++;
+            if (request->hdr.mtype == PRIORITY_URGENT) {
+                shm_hospital->shm_stats->urgent_requests++;
+            } else {
+                shm_hospital->shm_stats->normal_requests++;
+            }
+
+            // Update active requests in pharmacy SHM
             safe_pthread_mutex_lock(&shm_hospital->shm_pharm->global_mutex);
-            shm_hospital->shm_pharm->total_active_requests--;
+            shm_hospital->shm_pharm->total_active_requests++;
             safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->global_mutex);
+
+            // Log received request
+            char log_msg[128];
+            snprintf(log_msg, sizeof(log_msg), "Received pharmacy request for %s (%d items, op_id: %d, priority: %ld)",
+                     request->hdr.patient_id, request->meds_count, request->hdr.operation_id, request->hdr.mtype);
+            log_event(INFO, "PHARMACY", "REQUEST_RECV", log_msg);
+
+            // Spawn worker thread to handle this request
+            if (spawn_worker(request) != 0) {
+                log_event(ERROR, "PHARMACY", "SPAWN_FAIL", "Failed to spawn worker for request");
+
+                // Decrement active requests on failure
+                safe_pthread_mutex_lock(&shm_hospital->shm_pharm->global_mutex);
+                shm_hospital->shm_pharm->total_active_requests--;
+                safe_pthread_mutex_unlock(&shm_hospital->shm_pharm->global_mutex);
+            }
         }
     }
 }
@@ -636,7 +716,17 @@ void pharmacy_main(void) {
     
     // Seed random number generator
     srand((unsigned int)(time(NULL) ^ getpid()));
-    
+
+    // Start the async delivery-record writer (journal or file-per-patient layout)
+    if (config->results_journal_mode) {
+        char journal_path[256];
+        snprintf(journal_path, sizeof(journal_path),
+                 "results/pharmacy_deliveries/journal_%ld.log", (long)time(NULL));
+        results_writer_init("PHARMACY", journal_path);
+    } else {
+        results_writer_init("PHARMACY", NULL);
+    }
+
     #ifdef DEBUG
         log_event(DEBUG_LOG, "PHARMACY", "DISPATCHER_START", "Starting pharmacy request processing");
     #endif
@@ -671,7 +761,10 @@ void pharmacy_main(void) {
         }
     }
     safe_pthread_mutex_unlock(&workers_mutex);
-    
+
+    // Flush any pending delivery records before tearing down
+    results_writer_destroy();
+
     #ifdef DEBUG
         log_event(DEBUG_LOG, "PHARMACY", "CHILD_CLEANUP", "Calling child_cleanup");
     #endif
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../include/results_writer.h"
+#include "../include/safe_threads.h"
+#include "../include/log.h"
+
+// Asynchronous results-file writer, shared by the lab and pharmacy processes
+// (each process runs its own instance - the code is shared, not the queue).
+//
+// Workers used to fopen/fprintf/fclose one file per patient inside their
+// critical path, blocking on the filesystem while holding lab equipment
+// slots. Now they format the record, enqueue it into a bounded in-memory
+// queue and return immediately; a single background I/O thread drains the
+// queue in batches. Two output layouts:
+//   - journal mode: every record appended to one per-run journal file,
+//     indexed by a per-record header carrying the patient id
+//   - compatibility mode: the old file-per-patient layout, just off the
+//     worker's critical path
+// selected via RESULTS_JOURNAL_MODE in the config (journal_path == NULL
+// means compatibility mode).
+
+#define RW_QUEUE_CAP 256
+#define RW_BATCH_MAX 32
+
+typedef struct {
+    char filepath[256];     // Compatibility-mode target file
+    char patient_id[40];    // Journal-mode index key
+    size_t len;
+    char content[RW_CONTENT_MAX];
+} rw_record_t;
+
+static rw_record_t *rw_queue = NULL;
+static int rw_head = 0;
+static int rw_tail = 0;
+static int rw_count = 0;
+static int rw_running = 0;
+
+static pthread_mutex_t rw_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rw_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t rw_not_full = PTHREAD_COND_INITIALIZER;
+
+static pthread_t rw_thread;
+static FILE *rw_journal = NULL;
+static char rw_component[16] = "RESULTS";
+
+// Writes one record to its final destination (called from the I/O thread,
+// or inline as a fallback when the subsystem is not running)
+static void write_record(const rw_record_t *rec) {
+    if (rw_journal) {
+        fprintf(rw_journal, "=== RECORD patient=%s ===\n", rec->patient_id);
+        fwrite(rec->content, 1, rec->len, rw_journal);
+        fputc('\n', rw_journal);
+        return;
+    }
+
+    FILE *fp = fopen(rec->filepath, "w");
+    if (!fp) {
+        char log_msg[512];
+        snprintf(log_msg, sizeof(log_msg), "Failed to create results file: %s", rec->filepath);
+        log_event(ERROR, rw_component, "FILE_ERROR", log_msg);
+        return;
+    }
+    fwrite(rec->content, 1, rec->len, fp);
+    fclose(fp);
+}
+
+static void *rw_writer_main(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        safe_pthread_mutex_lock(&rw_mutex);
+        while (rw_count == 0 && rw_running) {
+            safe_pthread_cond_wait(&rw_not_empty, &rw_mutex);
+        }
+        if (rw_count == 0 && !rw_running) {
+            safe_pthread_mutex_unlock(&rw_mutex);
+            break;
+        }
+
+        // Grab a batch by index; producers only touch the tail, so the
+        // records in [head, head+n) are stable while we write unlocked
+        int n = (rw_count < RW_BATCH_MAX) ? rw_count : RW_BATCH_MAX;
+        int start = rw_head;
+        safe_pthread_mutex_unlock(&rw_mutex);
+
+        for (int i = 0; i < n; i++) {
+            write_record(&rw_queue[(start + i) % RW_QUEUE_CAP]);
+        }
+        if (rw_journal) fflush(rw_journal);
+
+        safe_pthread_mutex_lock(&rw_mutex);
+        rw_head = (rw_head + n) % RW_QUEUE_CAP;
+        rw_count -= n;
+        safe_pthread_cond_broadcast(&rw_not_full);
+        safe_pthread_mutex_unlock(&rw_mutex);
+    }
+
+    return NULL;
+}
+
+/**
+ * Start the async writer for this process
+ * @param component Log component tag ("LAB" / "PHARMACY")
+ * @param journal_path Append-only per-run journal, or NULL for the old
+ *                     file-per-patient layout
+ * @return 0 on success, -1 on failure
+ */
+int results_writer_init(const char *component, const char *journal_path) {
+    strncpy(rw_component, component, sizeof(rw_component) - 1);
+    rw_component[sizeof(rw_component) - 1] = '\0';
+
+    rw_queue = malloc(RW_QUEUE_CAP * sizeof(rw_record_t));
+    if (!rw_queue) {
+        log_event(ERROR, rw_component, "MALLOC_FAIL", "Failed to allocate results queue");
+        return -1;
+    }
+
+    if (journal_path) {
+        rw_journal = fopen(journal_path, "a");
+        if (!rw_journal) {
+            char log_msg[512];
+            snprintf(log_msg, sizeof(log_msg), "Failed to open journal: %s", journal_path);
+            log_event(ERROR, rw_component, "FILE_ERROR", log_msg);
+            // Fall through: compatibility layout still works
+        }
+    }
+
+    rw_head = rw_tail = rw_count = 0;
+    rw_running = 1;
+
+    if (safe_pthread_create(&rw_thread, NULL, rw_writer_main, NULL) != 0) {
+        log_event(ERROR, rw_component, "THREAD_FAIL", "Failed to create results writer thread");
+        rw_running = 0;
+        free(rw_queue);
+        rw_queue = NULL;
+        if (rw_journal) { fclose(rw_journal); rw_journal = NULL; }
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Enqueue a formatted record (worker side, returns without touching disk)
+ * Blocks only if the I/O thread is RW_QUEUE_CAP records behind
+ * @return 0 on success, -1 on failure
+ */
+int results_writer_enqueue(const char *filepath, const char *patient_id, const char *content) {
+    size_t len = strlen(content);
+    if (len > RW_CONTENT_MAX) len = RW_CONTENT_MAX;
+
+    safe_pthread_mutex_lock(&rw_mutex);
+
+    if (!rw_running || !rw_queue) {
+        // Subsystem down (init failed or already destroyed): write inline
+        safe_pthread_mutex_unlock(&rw_mutex);
+        rw_record_t rec;
+        strncpy(rec.filepath, filepath, sizeof(rec.filepath) - 1);
+        rec.filepath[sizeof(rec.filepath) - 1] = '\0';
+        strncpy(rec.patient_id, patient_id, sizeof(rec.patient_id) - 1);
+        rec.patient_id[sizeof(rec.patient_id) - 1] = '\0';
+        memcpy(rec.content, content, len);
+        rec.len = len;
+        write_record(&rec);
+        return 0;
+    }
+
+    while (rw_count == RW_QUEUE_CAP && rw_running) {
+        safe_pthread_cond_wait(&rw_not_full, &rw_mutex);
+    }
+
+    rw_record_t *rec = &rw_queue[rw_tail];
+    strncpy(rec->filepath, filepath, sizeof(rec->filepath) - 1);
+    rec->filepath[sizeof(rec->filepath) - 1] = '\0';
+    strncpy(rec->patient_id, patient_id, sizeof(rec->patient_id) - 1);
+    rec->patient_id[sizeof(rec->patient_id) - 1] = '\0';
+    memcpy(rec->content, content, len);
+    rec->len = len;
+
+    rw_tail = (rw_tail + 1) % RW_QUEUE_CAP;
+    rw_count++;
+    safe_pthread_cond_signal(&rw_not_empty);
+    safe_pthread_mutex_unlock(&rw_mutex);
+
+    return 0;
+}
+
+/**
+ * Flush remaining records, stop the I/O thread and release resources
+ */
+void results_writer_destroy(void) {
+    safe_pthread_mutex_lock(&rw_mutex);
+    if (!rw_running) {
+        safe_pthread_mutex_unlock(&rw_mutex);
+        return;
+    }
+    rw_running = 0;
+    safe_pthread_cond_broadcast(&rw_not_empty);
+    safe_pthread_cond_broadcast(&rw_not_full);
+    safe_pthread_mutex_unlock(&rw_mutex);
+
+    safe_pthread_join(rw_thread, NULL);
+
+    if (rw_journal) {
+        fclose(rw_journal);
+        rw_journal = NULL;
+    }
+    free(rw_queue);
+    rw_queue = NULL;
+}
@@ -16,6 +16,7 @@ int shm_surgery_id = -1;
 int shm_pharm_id = -1;
 int shm_lab_id = -1;
 int shm_log_id = -1;
+int shm_compl_id = -1;
 
 
 // Hospital SHM
@@ -89,6 +90,19 @@ static int create_shm() {
         }
     #endif
 
+    shm_compl_id = shmget(ftok(FTOK_PATH, SHM_COMPL_KEY), sizeof(completion_shm_t), IPC_CREAT | IPC_EXCL | 0666);
+    if (shm_compl_id == -1) {
+        log_event(ERROR, "IPC", "SHM_FAIL", "Failed to create shared memory");
+        return -1;
+    }
+    #ifdef DEBUG
+        {
+            char dbg[120];
+            snprintf(dbg, sizeof(dbg), "Created SHM_COMPLETION id=%d", shm_compl_id);
+            log_event(DEBUG_LOG, "IPC", "SHM_CREATE", dbg);
+        }
+    #endif
+
     return 0;
 }
 
@@ -163,20 +177,42 @@ int init_all_shm() {
         log_event(DEBUG_LOG, "IPC", "SHM_ATTACH", "Attached Critical Log SHM");
     #endif
 
+    // Completion table
+    shm_hospital->shm_compl = (completion_shm_t *) attach_shm(shm_compl_id);
+    if (shm_hospital->shm_compl == (void *)-1) {
+        log_event(ERROR, "IPC", "SHM", "Failed to attach Completion SHM");
+        return -1;
+    }
+    #ifdef DEBUG
+        log_event(DEBUG_LOG, "IPC", "SHM_ATTACH", "Attached Completion SHM");
+    #endif
+
     // --- Init SHM content ---
     memset(shm_hospital->shm_stats, 0, sizeof(global_statistics_shm_t));
     memset(shm_hospital->shm_surg, 0, sizeof(surgery_block_shm_t));
     memset(shm_hospital->shm_pharm, 0, sizeof(pharmacy_shm_t));
     memset(shm_hospital->shm_lab, 0, sizeof(lab_queue_shm_t));
     memset(shm_hospital->shm_critical_logger, 0, sizeof(critical_log_shm_t));
+    memset(shm_hospital->shm_compl, 0, sizeof(completion_shm_t));
 
     // --- Init all mutex's ---
     pthread_mutexattr_t attr;
     pthread_mutexattr_init(&attr);
     pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
 
-    // Stats Mutex
-    init_stats_default(shm_hospital->shm_stats, &attr);
+    // Stats + virtual time coordination
+    init_stats_default(shm_hospital->shm_stats);
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
+    safe_pthread_mutex_init(&shm_hospital->shm_stats->vt_mutex, &attr);
+    safe_pthread_cond_init(&shm_hospital->shm_stats->vt_cond, &cond_attr);
+
+    // Completion table doorbell
+    safe_pthread_mutex_init(&shm_hospital->shm_compl->mutex, &attr);
+    safe_pthread_cond_init(&shm_hospital->shm_compl->cond, &cond_attr);
+
+    pthread_condattr_destroy(&cond_attr);
 
     // Surgery Mutexes
     safe_pthread_mutex_init(&shm_hospital->shm_surg->teams_mutex, &attr);
@@ -217,7 +253,8 @@ void cleanup_all_shm() {
         if (shm_hospital->shm_pharm && shm_hospital->shm_pharm != (void *)-1) shmdt(shm_hospital->shm_pharm);
         if (shm_hospital->shm_lab && shm_hospital->shm_lab != (void *)-1) shmdt(shm_hospital->shm_lab);
         if (shm_hospital->shm_critical_logger && shm_hospital->shm_critical_logger != (void *)-1) shmdt(shm_hospital->shm_critical_logger);
-        
+        if (shm_hospital->shm_compl && shm_hospital->shm_compl != (void *)-1) shmdt(shm_hospital->shm_compl);
+
         // Free main container
         free(shm_hospital);
         shm_hospital = NULL;
@@ -269,6 +306,15 @@ void cleanup_all_shm() {
         #endif
         shm_log_id = -1;
     }
+    if (shm_compl_id != -1) {
+        (void)shmctl(shm_compl_id, IPC_RMID, NULL);
+        #ifdef DEBUG
+            char dbg[90];
+            snprintf(dbg, sizeof(dbg), "Removed SHM_COMPLETION id=%d", shm_compl_id);
+            log_event(DEBUG_LOG, "IPC", "SHM_RMID", dbg);
+        #endif
+        shm_compl_id = -1;
+    }
 }
 
 // Cleans SHM to avoid mem leaks in child processes
@@ -286,9 +332,12 @@ void cleanup_child_shm() {
         if (shm_hospital->shm_lab && shm_hospital->shm_lab != (void *)-1) 
             shmdt(shm_hospital->shm_lab);
             
-        if (shm_hospital->shm_critical_logger && shm_hospital->shm_critical_logger != (void *)-1) 
+        if (shm_hospital->shm_critical_logger && shm_hospital->shm_critical_logger != (void *)-1)
             shmdt(shm_hospital->shm_critical_logger);
-        
+
+        if (shm_hospital->shm_compl && shm_hospital->shm_compl != (void *)-1)
+            shmdt(shm_hospital->shm_compl);
+
         free(shm_hospital);
         shm_hospital = NULL;
     }
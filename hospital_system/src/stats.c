@@ -40,9 +40,9 @@ void display_statistics_console(global_statistics_shm_t *stats, const char *comp
 
     log_event(INFO, "STATS", "DISPLAY", "Displaying statistic to the console");
 
-    // Lock mutex for thread safety
-    safe_pthread_mutex_lock(&stats->mutex);
-    
+    // No lock needed: every counter is atomic and we accept slightly
+    // inconsistent cross-counter reads in exchange for zero writer stalls
+
     // Calculate Time Metrics
     char time_buf[30];
     get_time_str(time_buf, sizeof(time_buf)); // Assuming get_time_str exists
@@ -209,7 +209,6 @@ void display_statistics_console(global_statistics_shm_t *stats, const char *comp
     }
     printf("==========================================\n");
 
-    safe_pthread_mutex_unlock(&stats->mutex);
 }
 
 void save_statistics_snapshot(global_statistics_shm_t *stats) {
@@ -231,11 +230,9 @@ void save_statistics_snapshot(global_statistics_shm_t *stats) {
         return;
     }
 
-    safe_pthread_mutex_lock(&stats->mutex);
 
     if (!config) {
         log_event(ERROR, "STATS", "CONFIG_ERROR", "Configuration not available for stats snapshot");
-        safe_pthread_mutex_unlock(&stats->mutex);
         fclose(fp);
         return;
     }
@@ -370,21 +367,16 @@ void save_statistics_snapshot(global_statistics_shm_t *stats) {
     for(int k=0; k<width_lab2; k++) fprintf(fp, "*");
     fprintf(fp, "\n\n\n");
 
-    safe_pthread_mutex_unlock(&stats->mutex);
     fclose(fp);
     
     log_event(INFO, "STATS", "SNAPSHOT", "Statistics snapshot saved successfully");
 }
 
 // Initialize stats to the default value
-void init_stats_default(global_statistics_shm_t *stats, pthread_mutexattr_t *attr) {
+void init_stats_default(global_statistics_shm_t *stats) {
     if (!stats) return;
 
     memset(stats, 0, sizeof(*stats));
-    safe_pthread_mutex_init(&stats->mutex, attr);
-
-    // Lock to ensure safe initialization
-    safe_pthread_mutex_lock(&stats->mutex);
 
     // --- Triage ---
     stats->total_emergency_patients = 0;
@@ -432,6 +424,5 @@ void init_stats_default(global_statistics_shm_t *stats, pthread_mutexattr_t *att
     stats->system_start_time = time(NULL);
     stats->simulation_time_units = 0;
 
-    safe_pthread_mutex_unlock(&stats->mutex);
 }
 
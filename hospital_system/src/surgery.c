@@ -21,6 +21,8 @@
 #include "../include/time_simulation.h"
 #include "../include/manager_utils.h"
 #include "../include/pipes.h"
+#include "../include/completion.h"
+#include "../include/timeout_heap.h"
 
 // --- Constants ---
 #define ROOM_FREE       0
@@ -64,12 +66,12 @@ typedef struct ActiveSurgery {
     int needs_tests;        // 1 = requires lab tests
     int needs_meds;         // 1 = requires medications
     int active;             // 1 = still in workflow, 0 = completed/cancelled
-    
-    // Thread handle
-    pthread_t thread;
-    
+    int requests_sent;      // 1 = lab/pharmacy requests already out (resumed from pending)
+
     // Linked list for active surgeries registry
     struct ActiveSurgery *next;
+    // Admission queue link (separate from the registry list)
+    struct ActiveSurgery *q_next;
 } active_surgery_t;
 
 // --- Pending Surgery Structure ---
@@ -108,13 +110,25 @@ static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pending_surgery_t *pending_surgeries_head = NULL;
 static pthread_mutex_t pending_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Deadline index over the pending list (protected by pending_mutex)
+static timeout_heap_t pending_timeouts;
+
 // Condition variable for medical teams
 static pthread_cond_t teams_available_cond = PTHREAD_COND_INITIALIZER;
 
-// Active worker count for cleanup synchronization
-static int active_worker_count = 0;
-static pthread_mutex_t worker_count_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t workers_done_cond = PTHREAD_COND_INITIALIZER;
+// --- Worker Pool + Admission Queue ---
+// A fixed pool of workers drains an admission queue of surgery descriptors.
+// With three rooms and two teams, more runnable workers than rooms plus a
+// small lookahead only adds idle stacks, so a stress burst now costs one
+// malloc'd descriptor per surgery instead of one thread per surgery.
+#define SURGERY_POOL_SIZE 5     // 3 rooms + lookahead for dependency waits
+
+static pthread_t surgery_pool[SURGERY_POOL_SIZE];
+
+static active_surgery_t *admission_head = NULL;
+static active_surgery_t *admission_tail = NULL;
+static pthread_mutex_t admission_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t admission_cond = PTHREAD_COND_INITIALIZER;
 
 // --- Helper Functions ---
 
@@ -256,8 +270,11 @@ static void add_to_pending(active_surgery_t *surgery) {
     safe_pthread_mutex_lock(&pending_mutex);
     pending->next = pending_surgeries_head;
     pending_surgeries_head = pending;
+    timeout_heap_push(&pending_timeouts,
+                      pending->hold_start_time + MAX_WAIT_DEPENDENCIES_TIME,
+                      pending->surgery_id);
     safe_pthread_mutex_unlock(&pending_mutex);
-    
+
     char log_msg[150];
     snprintf(log_msg, sizeof(log_msg), "Surgery %d for %s put on hold (tests_done=%d, meds_ok=%d)",
              pending->surgery_id, pending->patient_id, pending->tests_done, pending->meds_ok);
@@ -279,48 +296,60 @@ static pending_surgery_t* find_pending_by_id(int surgery_id) {
 // Forward declaration for respawning from pending
 static void spawn_surgery_from_pending(pending_surgery_t *pending);
 
-// Check and remove expired pending surgeries
+// Check and remove expired pending surgeries. Deadlines are indexed in a
+// min-heap, so this pops only entries that actually expired instead of
+// walking the whole pending list under the lock on every dispatcher pass.
 static void check_pending_timeouts(void) {
     int current_time = get_simulation_time();
-    
+
     safe_pthread_mutex_lock(&pending_mutex);
-    
-    pending_surgery_t **curr = &pending_surgeries_head;
-    while (*curr) {
-        int wait_time = current_time - (*curr)->hold_start_time;
-        if (wait_time >= MAX_WAIT_DEPENDENCIES_TIME) {
-            pending_surgery_t *expired = *curr;
-            *curr = expired->next;
-            
-            char log_msg[150];
-            snprintf(log_msg, sizeof(log_msg), 
-                     "Surgery %d for %s cancelled (exceeded max hold time of %d)",
-                     expired->surgery_id, expired->patient_id, MAX_WAIT_DEPENDENCIES_TIME);
-            log_event(WARNING, "SURGERY", "HOLD_TIMEOUT", log_msg);
-                        
-            #ifdef DEBUG
-                {
-                    char debug_msg[120];
-                    snprintf(debug_msg, sizeof(debug_msg), 
-                            "SURGERY_TIMEOUT: %s (meds: %d/%d; tests: %d/%d)", 
-                            expired->patient_id, 
-                            expired->meds_ok, expired->needs_meds,
-                            expired->tests_done, expired->needs_tests);
-                    log_event(DEBUG_LOG, "SURGERY", "TIMEOUT_STATUS", debug_msg);
-                }
-            #endif
-            
-            // Update cancelled surgeries stat
-            safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-            shm_hospital->shm_stats->cancelled_surgeries++;
-            safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
-            
-            free(expired);
-        } else {
+
+    int surgery_id;
+    while ((surgery_id = timeout_heap_pop_expired(&pending_timeouts, current_time)) != -1) {
+        // Lazy removal: surgeries respawned before their deadline are no
+        // longer in the pending list - their heap entry is just skipped
+        pending_surgery_t **curr = &pending_surgeries_head;
+        while (*curr && (*curr)->surgery_id != surgery_id) {
             curr = &(*curr)->next;
         }
+        if (!*curr) continue;
+
+        // Guard against id reuse: if this entry belongs to a newer hold with
+        // the same id, re-index it with its real deadline
+        if (current_time - (*curr)->hold_start_time < MAX_WAIT_DEPENDENCIES_TIME) {
+            timeout_heap_push(&pending_timeouts,
+                              (*curr)->hold_start_time + MAX_WAIT_DEPENDENCIES_TIME,
+                              surgery_id);
+            continue;
+        }
+
+        pending_surgery_t *expired = *curr;
+        *curr = expired->next;
+
+        char log_msg[150];
+        snprintf(log_msg, sizeof(log_msg),
+                 "Surgery %d for %s cancelled (exceeded max hold time of %d)",
+                 expired->surgery_id, expired->patient_id, MAX_WAIT_DEPENDENCIES_TIME);
+        log_event(WARNING, "SURGERY", "HOLD_TIMEOUT", log_msg);
+
+        #ifdef DEBUG
+            {
+                char debug_msg[120];
+                snprintf(debug_msg, sizeof(debug_msg),
+                        "SURGERY_TIMEOUT: %s (meds: %d/%d; tests: %d/%d)",
+                        expired->patient_id,
+                        expired->meds_ok, expired->needs_meds,
+                        expired->tests_done, expired->needs_tests);
+                log_event(DEBUG_LOG, "SURGERY", "TIMEOUT_STATUS", debug_msg);
+            }
+        #endif
+
+        // Update cancelled surgeries stat
+        shm_hospital->shm_stats->cancelled_surgeries++;
+
+        free(expired);
     }
-    
+
     safe_pthread_mutex_unlock(&pending_mutex);
 }
 
@@ -430,67 +459,80 @@ static int send_pharmacy_request_async(active_surgery_t *surgery) {
     return 0;
 }
 
-// --- Wait for Dependencies (Worker waits on its own cond var with timeout) ---
+// --- Wait for Dependencies (Worker waits directly on its SHM completion slot) ---
+// Lab/pharmacy post their result into the slot and ring the shared doorbell,
+// so the worker wakes without waiting for the dispatcher to drain the queue.
+// The queue message still arrives and is handled idempotently (it also covers
+// surgeries sitting on the pending list, which have no thread to wake).
 // Returns: 0 = dependencies ready, 1 = timeout (put on hold), -1 = error/shutdown
 
 static int wait_for_dependencies(active_surgery_t *surgery) {
     struct timespec timeout;
     int rc;
-    
-    safe_pthread_mutex_lock(&surgery->mutex);
-    
+
+    // Absolute hold deadline, computed once (doorbell broadcasts are shared
+    // by all waiters, so per-wait timeout resets would never expire)
+    if (clock_gettime(CLOCK_REALTIME, &timeout) != 0) {
+        log_event(ERROR, "SURGERY", "CLOCK_FAIL", "clock_gettime failed");
+        return -1;
+    }
+
+    long total_ms = (long)INITIAL_DEPENDENCY_TIMEOUT * config->time_unit_ms;
+    timeout.tv_sec += total_ms / 1000;
+    timeout.tv_nsec += (total_ms % 1000) * 1000000L;
+
+    // Handle nanosecond overflow (tv_nsec must be < 1 billion)
+    if (timeout.tv_nsec >= 1000000000L) {
+        timeout.tv_sec += timeout.tv_nsec / 1000000000L;
+        timeout.tv_nsec = timeout.tv_nsec % 1000000000L;
+    }
+
     while (!check_shutdown()) {
-        // Check if both dependencies are satisfied
+        // Merge the completion slot into the local flags (the dispatcher's
+        // queue-message path may also have set them - both are idempotent)
+        int lab_result, pharm_result;
+        completion_check(surgery->surgery_id, &lab_result, &pharm_result);
+
+        safe_pthread_mutex_lock(&surgery->mutex);
+        if (lab_result != COMPLETION_PENDING) surgery->tests_done = 1;
+        if (pharm_result != COMPLETION_PENDING) surgery->meds_ok = 1;
+
         int tests_satisfied = !surgery->needs_tests || surgery->tests_done;
         int meds_satisfied = !surgery->needs_meds || surgery->meds_ok;
-        
+        safe_pthread_mutex_unlock(&surgery->mutex);
+
         if (tests_satisfied && meds_satisfied) {
-            safe_pthread_mutex_unlock(&surgery->mutex);
             log_event(INFO, "SURGERY", "DEPS_READY", surgery->patient_id);
             return 0;
         }
-        
-        // Calculate absolute timeout based on simulation time units
-        if (clock_gettime(CLOCK_REALTIME, &timeout) != 0) {
-            log_event(ERROR, "SURGERY", "CLOCK_FAIL", "clock_gettime failed");
-            safe_pthread_mutex_unlock(&surgery->mutex);
-            return -1;
-        }
-        
-        long total_ms = (long)INITIAL_DEPENDENCY_TIMEOUT * config->time_unit_ms;
-        long add_sec = total_ms / 1000;
-        long add_nsec = (total_ms % 1000) * 1000000L;
-        
-        timeout.tv_sec += add_sec;
-        timeout.tv_nsec += add_nsec;
-        
-        // Handle nanosecond overflow (tv_nsec must be < 1 billion)
-        if (timeout.tv_nsec >= 1000000000L) {
-            timeout.tv_sec += timeout.tv_nsec / 1000000000L;
-            timeout.tv_nsec = timeout.tv_nsec % 1000000000L;
-        }
-        
-        // Wait for dispatcher to signal us (with timeout)
-        rc = safe_pthread_cond_timedwait(&surgery->cond, &surgery->mutex, &timeout);
-        
+
+        // Block on the shared doorbell until some result is posted
+        rc = completion_timedwait(&timeout);
+
         if (rc == ETIMEDOUT) {
             // Timeout expired - check one more time if dependencies were satisfied
+            completion_check(surgery->surgery_id, &lab_result, &pharm_result);
+
+            safe_pthread_mutex_lock(&surgery->mutex);
+            if (lab_result != COMPLETION_PENDING) surgery->tests_done = 1;
+            if (pharm_result != COMPLETION_PENDING) surgery->meds_ok = 1;
+
             int tests_ok = !surgery->needs_tests || surgery->tests_done;
             int meds_ok_flag = !surgery->needs_meds || surgery->meds_ok;
-            
+
             if (tests_ok && meds_ok_flag) {
                 safe_pthread_mutex_unlock(&surgery->mutex);
                 log_event(INFO, "SURGERY", "DEPS_READY", surgery->patient_id);
                 return 0;
             }
-            
+
             // Timeout - patient will be put on hold
             char log_msg[150];
-            snprintf(log_msg, sizeof(log_msg), 
+            snprintf(log_msg, sizeof(log_msg),
                      "Initial timeout for %s, putting on hold (tests_done=%d, meds_ok=%d)",
                      surgery->patient_id, surgery->tests_done, surgery->meds_ok);
             log_event(INFO, "SURGERY", "TIMEOUT_HOLD", log_msg);
-            
+
             safe_pthread_mutex_unlock(&surgery->mutex);
             return 1; // Put on hold
         } else if (rc != 0 && rc != EINTR) {
@@ -498,14 +540,12 @@ static int wait_for_dependencies(active_surgery_t *surgery) {
             char err_msg[100];
             snprintf(err_msg, sizeof(err_msg), "pthread_cond_timedwait failed: %d", rc);
             log_event(ERROR, "SURGERY", "COND_WAIT_FAIL", err_msg);
-            safe_pthread_mutex_unlock(&surgery->mutex);
             return -1;
         }
-        // rc == 0 means we were signaled, loop back and check conditions
+        // rc == 0 means the doorbell rang, loop back and re-check our slot
         // rc == EINTR means interrupted, loop back and try again
     }
-    
-    safe_pthread_mutex_unlock(&surgery->mutex);
+
     return -1; // Shutdown
 }
 
@@ -634,7 +674,6 @@ static void perform_surgery(active_surgery_t *surgery) {
     wait_time_units(duration);
     
     // Update statistics
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     switch (surgery->surgery_type) {
         case SURGERY_CARDIO:
             shm_hospital->shm_stats->total_surgeries_bo1++;
@@ -649,7 +688,6 @@ static void perform_surgery(active_surgery_t *surgery) {
             shm_hospital->shm_stats->bo3_utilization_time += duration;
             break;
     }
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     snprintf(log_msg, sizeof(log_msg), "Surgery completed for %s in %s", 
              surgery->patient_id, get_room_name(surgery->surgery_type));
@@ -674,53 +712,55 @@ static void cleanup_room(active_surgery_t *surgery) {
     wait_time_units(cleanup_duration);
 }
 
-// --- Surgery Worker Thread ---
+// --- Surgery Processing (runs on a pool worker) ---
 
-static void *surgery_worker(void *arg) {
-    active_surgery_t *surgery = (active_surgery_t *)arg;
-    
+static void process_surgery(active_surgery_t *surgery) {
     char log_msg[150];
-    snprintf(log_msg, sizeof(log_msg), "Surgery thread started for %s (type: %s, scheduled: %d)", 
+    snprintf(log_msg, sizeof(log_msg), "Surgery processing started for %s (type: %s, scheduled: %d)",
              surgery->patient_id, get_room_name(surgery->surgery_type), surgery->scheduled_time);
     log_event(INFO, "SURGERY", "THREAD_START", log_msg);
-    
+
     // ==========================================
-    // Step 1: Registration (already done before thread creation)
+    // Step 1: Registration (already done before admission)
     // ==========================================
-    
+
     // ==========================================
     // Step 2: Send Async Requests
     // ==========================================
-    
-    safe_pthread_mutex_lock(&surgery->mutex);
-    
-    if (send_lab_request_async(surgery) != 0) {
-        surgery->active = 0;
-        safe_pthread_mutex_unlock(&surgery->mutex);
-        goto surgery_cancelled;
-    }
-    
-    if (send_pharmacy_request_async(surgery) != 0) {
-        surgery->active = 0;
+    // Skipped for surgeries resumed from the pending list - their lab and
+    // pharmacy requests went out in the first pass and are already satisfied.
+
+    if (!surgery->requests_sent) {
+        safe_pthread_mutex_lock(&surgery->mutex);
+
+        if (send_lab_request_async(surgery) != 0) {
+            surgery->active = 0;
+            safe_pthread_mutex_unlock(&surgery->mutex);
+            goto surgery_cancelled;
+        }
+
+        if (send_pharmacy_request_async(surgery) != 0) {
+            surgery->active = 0;
+            safe_pthread_mutex_unlock(&surgery->mutex);
+            goto surgery_cancelled;
+        }
+
         safe_pthread_mutex_unlock(&surgery->mutex);
-        goto surgery_cancelled;
-    }
-    
-    safe_pthread_mutex_unlock(&surgery->mutex);
-    
-    // ==========================================
-    // Step 3: Wait for Dependencies
-    // ==========================================
-    
-    int dep_result = wait_for_dependencies(surgery);
-    if (dep_result == 1) {
-        // Put on hold - add to pending list and free worker
-        add_to_pending(surgery);
-        goto put_on_hold;
-    } else if (dep_result != 0) {
-        goto surgery_cancelled;
+
+        // ==========================================
+        // Step 3: Wait for Dependencies
+        // ==========================================
+
+        int dep_result = wait_for_dependencies(surgery);
+        if (dep_result == 1) {
+            // Put on hold - add to pending list and free the descriptor
+            add_to_pending(surgery);
+            goto put_on_hold;
+        } else if (dep_result != 0) {
+            goto surgery_cancelled;
+        }
     }
-    
+
     if (check_shutdown()) goto surgery_cancelled;
     
     // ==========================================
@@ -734,9 +774,7 @@ static void *surgery_worker(void *arg) {
     // Update surgery wait time statistics (time spent waiting after dependencies ready)
     int actual_wait_time = time_after_wait - time_before_wait;
     if (actual_wait_time > 0) {
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         shm_hospital->shm_stats->total_surgery_wait_time += (double)actual_wait_time;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     }
     
     if (check_shutdown()) goto surgery_cancelled;
@@ -779,10 +817,8 @@ static void *surgery_worker(void *arg) {
     release_room(surgery);
     
     // 6e. Update statistics
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->completed_surgeries++;
     shm_hospital->shm_stats->total_operations++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     snprintf(log_msg, sizeof(log_msg), "Surgery workflow complete for %s", surgery->patient_id);
     log_event(INFO, "SURGERY", "WORKFLOW_COMPLETE", log_msg);
@@ -790,9 +826,7 @@ static void *surgery_worker(void *arg) {
     goto cleanup;
 
 surgery_cancelled:
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     shm_hospital->shm_stats->cancelled_surgeries++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     snprintf(log_msg, sizeof(log_msg), "Surgery cancelled for %s", surgery->patient_id);
     log_event(WARNING, "SURGERY", "SURGERY_CANCELLED", log_msg);
@@ -812,46 +846,87 @@ surgery_cancelled:
     goto cleanup;
 
 put_on_hold:
-    // Worker exits but surgery data is preserved in pending list
+    // Pool worker moves on but surgery data is preserved in pending list
     // No statistics update here - will be updated when respawned or expired
     unregister_surgery(surgery);
     safe_pthread_mutex_destroy(&surgery->mutex);
     safe_pthread_cond_destroy(&surgery->cond);
     free(surgery);
-    
-    // Decrement worker count and signal if done
-    safe_pthread_mutex_lock(&worker_count_mutex);
-    active_worker_count--;
-    if (active_worker_count == 0) {
-        safe_pthread_cond_signal(&workers_done_cond);
-    }
-    safe_pthread_mutex_unlock(&worker_count_mutex);
-    
-    return NULL;
+    return;
 
 cleanup:
     // Mark as inactive
     safe_pthread_mutex_lock(&surgery->mutex);
     surgery->active = 0;
     safe_pthread_mutex_unlock(&surgery->mutex);
-    
+
     // Unregister from active surgeries
     unregister_surgery(surgery);
-    
+
     // Cleanup synchronization primitives
     safe_pthread_mutex_destroy(&surgery->mutex);
     safe_pthread_cond_destroy(&surgery->cond);
-    
+
     free(surgery);
-    
-    // Decrement worker count and signal if done
-    safe_pthread_mutex_lock(&worker_count_mutex);
-    active_worker_count--;
-    if (active_worker_count == 0) {
-        safe_pthread_cond_signal(&workers_done_cond);
+}
+
+// --- Admission Queue + Pool Worker ---
+
+static void admission_push(active_surgery_t *surgery) {
+    surgery->q_next = NULL;
+
+    safe_pthread_mutex_lock(&admission_mutex);
+    if (admission_tail) {
+        admission_tail->q_next = surgery;
+    } else {
+        admission_head = surgery;
     }
-    safe_pthread_mutex_unlock(&worker_count_mutex);
-    
+    admission_tail = surgery;
+    safe_pthread_cond_signal(&admission_cond);
+    safe_pthread_mutex_unlock(&admission_mutex);
+}
+
+// Timed pop so pool workers re-check the shutdown flag even if the final
+// broadcast races a worker entering the wait. Returns NULL on timeout/shutdown.
+static active_surgery_t *admission_pop(void) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += 100000000L;  // 100ms
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    safe_pthread_mutex_lock(&admission_mutex);
+    while (!admission_head && !check_shutdown()) {
+        if (pthread_cond_timedwait(&admission_cond, &admission_mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+
+    active_surgery_t *surgery = admission_head;
+    if (surgery) {
+        admission_head = surgery->q_next;
+        if (!admission_head) admission_tail = NULL;
+        surgery->q_next = NULL;
+    }
+    safe_pthread_mutex_unlock(&admission_mutex);
+
+    return surgery;
+}
+
+static void *surgery_worker(void *arg) {
+    (void)arg;
+
+    while (1) {
+        active_surgery_t *surgery = admission_pop();
+        if (!surgery) {
+            if (check_shutdown()) break;
+            continue;
+        }
+        process_surgery(surgery);
+    }
+
     return NULL;
 }
 
@@ -982,6 +1057,9 @@ static void handle_pharmacy_response(int surgery_id) {
 // --- Dispatcher: Broadcast Shutdown to All Workers ---
 
 static void broadcast_shutdown_to_workers(void) {
+    // Wake workers blocked on the completion doorbell
+    completion_broadcast();
+
     safe_pthread_mutex_lock(&registry_mutex);
     
     active_surgery_t *curr = active_surgeries_head;
@@ -998,7 +1076,12 @@ static void broadcast_shutdown_to_workers(void) {
     safe_pthread_mutex_lock(&shm_hospital->shm_surg->teams_mutex);
     safe_pthread_cond_broadcast(&teams_available_cond);
     safe_pthread_mutex_unlock(&shm_hospital->shm_surg->teams_mutex);
-    
+
+    // Wake pool workers idling on the admission queue
+    safe_pthread_mutex_lock(&admission_mutex);
+    safe_pthread_cond_broadcast(&admission_cond);
+    safe_pthread_mutex_unlock(&admission_mutex);
+
     log_event(INFO, "SURGERY", "SHUTDOWN_BROADCAST", "Shutdown signal sent to all workers");
 }
 
@@ -1029,144 +1112,28 @@ static void spawn_surgery_worker(msg_new_surgery_t *msg) {
     safe_pthread_mutex_init(&surgery->mutex, NULL);
     safe_pthread_cond_init(&surgery->cond, NULL);
     
-    // Initialize status flags
+    // Initialize status flags (and reset this operation's completion slot
+    // before any request goes out)
+    completion_claim(surgery->surgery_id);
     surgery->tests_done = 0;
     surgery->meds_ok = 0;
     surgery->needs_tests = (msg->tests_count > 0);
     surgery->needs_meds = (msg->meds_count > 0);
     surgery->active = 1;
+    surgery->requests_sent = 0;
     surgery->next = NULL;
-    
-    // Register in active surgeries list BEFORE spawning thread
+
+    // Register in active surgeries list BEFORE queueing
     register_surgery(surgery);
-    
+
     char log_msg[150];
-    snprintf(log_msg, sizeof(log_msg), "New surgery: %s (type: %s, urgency: %d, scheduled: %d)", 
-             surgery->patient_id, get_room_name(surgery->surgery_type), 
+    snprintf(log_msg, sizeof(log_msg), "New surgery: %s (type: %s, urgency: %d, scheduled: %d)",
+             surgery->patient_id, get_room_name(surgery->surgery_type),
              surgery->urgency, surgery->scheduled_time);
     log_event(INFO, "SURGERY", "TASK_RECEIVED", log_msg);
-    
-    // Increment active worker count BEFORE creating thread (will be decremented by thread on exit)
-    safe_pthread_mutex_lock(&worker_count_mutex);
-    active_worker_count++;
-    safe_pthread_mutex_unlock(&worker_count_mutex);
-    
-    // Spawn worker thread
-    if (safe_pthread_create(&surgery->thread, NULL, surgery_worker, surgery) != 0) {
-        log_event(ERROR, "SURGERY", "THREAD_FAIL", "Failed to create surgery worker thread");
-        // Undo the increment since thread didn't start
-        safe_pthread_mutex_lock(&worker_count_mutex);
-        active_worker_count--;
-        safe_pthread_mutex_unlock(&worker_count_mutex);
-        unregister_surgery(surgery);
-        safe_pthread_mutex_destroy(&surgery->mutex);
-        safe_pthread_cond_destroy(&surgery->cond);
-        free(surgery);
-        return;
-    }
-    
-    // Detach thread for automatic cleanup
-    safe_pthread_detach(surgery->thread);
-}
-
-// --- Surgery Worker Thread for Resumed Surgeries (from pending) ---
-// This worker skips dependency requests since they were already handled
 
-static void *surgery_worker_resumed(void *arg) {
-    active_surgery_t *surgery = (active_surgery_t *)arg;
-    
-    char log_msg[150];
-    snprintf(log_msg, sizeof(log_msg), "Resumed surgery thread for %s (deps already satisfied)", 
-             surgery->patient_id);
-    log_event(INFO, "SURGERY", "THREAD_RESUMED", log_msg);
-    
-    // Dependencies are already satisfied, proceed directly to scheduled time wait
-    
-    if (check_shutdown()) goto surgery_cancelled;
-    
-    // ==========================================
-    // Step 4: Wait for Scheduled Time
-    // ==========================================
-    
-    int time_before_wait = get_simulation_time();
-    wait_for_scheduled_time(surgery);
-    int time_after_wait = get_simulation_time();
-    
-    // Update surgery wait time statistics
-    int actual_wait_time = time_after_wait - time_before_wait;
-    if (actual_wait_time > 0) {
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-        shm_hospital->shm_stats->total_surgery_wait_time += (double)actual_wait_time;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
-    }
-    
-    if (check_shutdown()) goto surgery_cancelled;
-    
-    // ==========================================
-    // Step 5: Resource Acquisition
-    // ==========================================
-    
-    if (acquire_room(surgery) != 0) {
-        goto surgery_cancelled;
-    }
-    
-    if (acquire_medical_team(surgery) != 0) {
-        release_room(surgery);
-        goto surgery_cancelled;
-    }
-    
-    if (check_shutdown()) {
-        release_medical_team(surgery);
-        release_room(surgery);
-        goto surgery_cancelled;
-    }
-    
-    // ==========================================
-    // Step 6: Execution
-    // ==========================================
-    
-    perform_surgery(surgery);
-    release_medical_team(surgery);
-    cleanup_room(surgery);
-    release_room(surgery);
-    
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-    shm_hospital->shm_stats->completed_surgeries++;
-    shm_hospital->shm_stats->total_operations++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
-    
-    snprintf(log_msg, sizeof(log_msg), "Resumed surgery workflow complete for %s", surgery->patient_id);
-    log_event(INFO, "SURGERY", "WORKFLOW_COMPLETE", log_msg);
-    
-    goto cleanup;
-
-surgery_cancelled:
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-    shm_hospital->shm_stats->cancelled_surgeries++;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
-    
-    snprintf(log_msg, sizeof(log_msg), "Resumed surgery cancelled for %s", surgery->patient_id);
-    log_event(WARNING, "SURGERY", "SURGERY_CANCELLED", log_msg);
-
-cleanup:
-    safe_pthread_mutex_lock(&surgery->mutex);
-    surgery->active = 0;
-    safe_pthread_mutex_unlock(&surgery->mutex);
-    
-    unregister_surgery(surgery);
-    safe_pthread_mutex_destroy(&surgery->mutex);
-    safe_pthread_cond_destroy(&surgery->cond);
-    free(surgery);
-    
-    // Decrement worker count and signal if done
-    safe_pthread_mutex_lock(&worker_count_mutex);
-    active_worker_count--;
-    if (active_worker_count == 0) {
-        safe_pthread_cond_signal(&workers_done_cond);
-    }
-    safe_pthread_mutex_unlock(&worker_count_mutex);
-    
-    return NULL;
+    // Hand off to the worker pool
+    admission_push(surgery);
 }
 
 // --- Spawn Surgery from Pending (dependencies already satisfied) ---
@@ -1197,45 +1164,28 @@ static void spawn_surgery_from_pending(pending_surgery_t *pending) {
     safe_pthread_mutex_init(&surgery->mutex, NULL);
     safe_pthread_cond_init(&surgery->cond, NULL);
     
-    // Dependencies are already satisfied
+    // Dependencies are already satisfied - pool worker skips Steps 2-3
     surgery->tests_done = 1;
     surgery->meds_ok = 1;
     surgery->needs_tests = pending->needs_tests;
     surgery->needs_meds = pending->needs_meds;
     surgery->active = 1;
+    surgery->requests_sent = 1;
     surgery->next = NULL;
-    
+
     // Free pending structure
     free(pending);
-    
+
     // Register in active surgeries list
     register_surgery(surgery);
-    
+
     char log_msg[150];
-    snprintf(log_msg, sizeof(log_msg), "Respawning surgery: %s (type: %s, from pending)", 
+    snprintf(log_msg, sizeof(log_msg), "Respawning surgery: %s (type: %s, from pending)",
              surgery->patient_id, get_room_name(surgery->surgery_type));
     log_event(INFO, "SURGERY", "RESPAWN_START", log_msg);
-    
-    // Increment active worker count BEFORE creating thread (will be decremented by thread on exit)
-    safe_pthread_mutex_lock(&worker_count_mutex);
-    active_worker_count++;
-    safe_pthread_mutex_unlock(&worker_count_mutex);
-    
-    // Spawn resumed worker thread
-    if (safe_pthread_create(&surgery->thread, NULL, surgery_worker_resumed, surgery) != 0) {
-        log_event(ERROR, "SURGERY", "THREAD_FAIL", "Failed to create resumed surgery worker thread");
-        // Undo the increment since thread didn't start
-        safe_pthread_mutex_lock(&worker_count_mutex);
-        active_worker_count--;
-        safe_pthread_mutex_unlock(&worker_count_mutex);
-        unregister_surgery(surgery);
-        safe_pthread_mutex_destroy(&surgery->mutex);
-        safe_pthread_cond_destroy(&surgery->cond);
-        free(surgery);
-        return;
-    }
-    
-    safe_pthread_detach(surgery->thread);
+
+    // Hand off to the worker pool
+    admission_push(surgery);
 }
 
 // --- Dispatcher Main Loop ---
@@ -1312,42 +1262,50 @@ void surgery_main(void) {
     
     // Initialize global condition variable for medical teams
     safe_pthread_cond_init(&teams_available_cond, NULL);
-    
+
+    // Initialize the pending timeout index
+    if (timeout_heap_init(&pending_timeouts, 64) != 0) {
+        log_event(ERROR, "SURGERY", "MALLOC_FAIL", "Failed to allocate timeout heap");
+    }
+
+    // Start the fixed worker pool that drains the admission queue
+    int pool_started = 0;
+    for (int i = 0; i < SURGERY_POOL_SIZE; i++) {
+        if (safe_pthread_create(&surgery_pool[i], NULL, surgery_worker, NULL) != 0) {
+            log_event(ERROR, "SURGERY", "THREAD_FAIL", "Failed to create pool worker thread");
+            break;
+        }
+        pool_started++;
+    }
+
     #ifdef DEBUG
         log_event(DEBUG_LOG, "SURGERY", "DISPATCHER_START", "Starting dispatcher loop");
     #endif
     // Run dispatcher loop (this is the main thread)
     dispatcher_loop();
-    
+
     #ifdef DEBUG
-        log_event(DEBUG_LOG, "SURGERY", "WAIT_WORKERS", "Waiting for worker threads to complete");
+        log_event(DEBUG_LOG, "SURGERY", "WAIT_WORKERS", "Waiting for pool workers to complete");
     #endif
-    // Wait for all worker threads to complete (with timeout)
-    safe_pthread_mutex_lock(&worker_count_mutex);
-    
-    // Use timed wait to avoid blocking forever during shutdown
-    struct timespec ts;
-    int max_wait_seconds = 5; // Maximum 5 seconds to wait for workers
-    
-    while (active_worker_count > 0) {
-        clock_gettime(CLOCK_REALTIME, &ts);
-        ts.tv_sec += 1; // 1 second timeout per iteration
-        
-        int rc = pthread_cond_timedwait(&workers_done_cond, &worker_count_mutex, &ts);
-        if (rc == ETIMEDOUT) {
-            max_wait_seconds--;
-            if (max_wait_seconds <= 0) {
-                // Timeout expired, force exit - workers will be cleaned up by OS
-                char log_msg[128];
-                snprintf(log_msg, sizeof(log_msg), 
-                         "Timeout waiting for %d workers, forcing cleanup", active_worker_count);
-                log_event(WARNING, "SURGERY", "WORKER_TIMEOUT", log_msg);
-                break;
-            }
-        }
+    // Join the pool - workers exit once the shutdown flag is set and their
+    // current surgery (if any) reaches a cancel/cleanup point
+    for (int i = 0; i < pool_started; i++) {
+        safe_pthread_join(surgery_pool[i], NULL);
     }
-    safe_pthread_mutex_unlock(&worker_count_mutex);
-    
+
+    // Free any surgeries still sitting in the admission queue
+    safe_pthread_mutex_lock(&admission_mutex);
+    while (admission_head) {
+        active_surgery_t *next = admission_head->q_next;
+        unregister_surgery(admission_head);
+        safe_pthread_mutex_destroy(&admission_head->mutex);
+        safe_pthread_cond_destroy(&admission_head->cond);
+        free(admission_head);
+        admission_head = next;
+    }
+    admission_tail = NULL;
+    safe_pthread_mutex_unlock(&admission_mutex);
+
     #ifdef DEBUG
         log_event(DEBUG_LOG, "SURGERY", "CLEANUP_ACTIVE", "Cleaning up remaining active surgeries");
     #endif
@@ -1379,6 +1337,7 @@ void surgery_main(void) {
     #endif
     // Process resources cleanup
     safe_pthread_cond_destroy(&teams_available_cond);
+    timeout_heap_destroy(&pending_timeouts);
     
     #ifdef DEBUG
         log_event(DEBUG_LOG, "SURGERY", "CHILD_CLEANUP", "Calling child_cleanup");
@@ -2,6 +2,8 @@
 
 #include <unistd.h>
 #include <errno.h>
+#include <time.h>
+#include <stdatomic.h>
 
 #include "../include/config.h"
 #include "../include/time_simulation.h"
@@ -9,14 +11,56 @@
 #include "../include/safe_threads.h"
 #include "../include/manager_utils.h"
 
+// Virtual-time wait: register our wake deadline in a SHM slot so the manager
+// can fast-forward the clock to it, then sleep on vt_cond until the clock
+// (real ticks or a jump) reaches the deadline. Timed waits in 100ms slices
+// keep the shutdown flag responsive even if a broadcast is missed.
+static void virtual_wait(int units) {
+    global_statistics_shm_t *stats = shm_hospital->shm_stats;
+    int deadline = stats->simulation_time_units + units;
+
+    int slot = -1;
+    for (int i = 0; i < VT_MAX_WAITERS; i++) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&stats->vt_waiter_deadline[i], &expected, deadline)) {
+            slot = i;
+            break;
+        }
+    }
+    // No free slot: the manager can't see this deadline, but real ticks still
+    // advance the clock, so the wait below degrades to real-time pace.
+
+    safe_pthread_mutex_lock(&stats->vt_mutex);
+    while (stats->simulation_time_units < deadline && !check_shutdown()) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 100000000L; // 100ms
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        safe_pthread_cond_timedwait(&stats->vt_cond, &stats->vt_mutex, &ts);
+    }
+    safe_pthread_mutex_unlock(&stats->vt_mutex);
+
+    if (slot != -1) {
+        atomic_store(&stats->vt_waiter_deadline[slot], 0);
+    }
+}
+
 void wait_time_units(int units) {
     if (units <= 0) return;
-    
+
+    if (config && config->virtual_time_enabled && shm_hospital && shm_hospital->shm_stats) {
+        virtual_wait(units);
+        return;
+    }
+
     // Sleep in small intervals to allow shutdown checks
     // Use 100ms intervals (same as semaphore timeout)
     long interval_us = 100000; // 100ms in microseconds
     long total_us = (long)units * config->time_unit_ms * 1000;
-    
+
     while (total_us > 0 && !check_shutdown()) {
         long sleep_time = (total_us < interval_us) ? total_us : interval_us;
         int result = usleep(sleep_time);
@@ -28,17 +72,39 @@ void wait_time_units(int units) {
     }
 }
 
+// Manager-side: earliest wake deadline registered by any virtual waiter
+// (-1 if none are blocked)
+int vt_earliest_deadline(void) {
+    if (!shm_hospital || !shm_hospital->shm_stats) return -1;
+
+    global_statistics_shm_t *stats = shm_hospital->shm_stats;
+    int earliest = -1;
+    for (int i = 0; i < VT_MAX_WAITERS; i++) {
+        int d = atomic_load(&stats->vt_waiter_deadline[i]);
+        if (d > 0 && (earliest == -1 || d < earliest)) earliest = d;
+    }
+    return earliest;
+}
+
+// Manager-side: publish a new clock value and wake every blocked waiter
+void vt_publish_time(int new_time) {
+    if (!shm_hospital || !shm_hospital->shm_stats) return;
+
+    global_statistics_shm_t *stats = shm_hospital->shm_stats;
+    safe_pthread_mutex_lock(&stats->vt_mutex);
+    stats->simulation_time_units = new_time;
+    safe_pthread_cond_broadcast(&stats->vt_cond);
+    safe_pthread_mutex_unlock(&stats->vt_mutex);
+}
+
 int get_simulation_time(void) {
     if (!shm_hospital || !shm_hospital->shm_stats) return 0;
-    
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
+
     int time = shm_hospital->shm_stats->simulation_time_units;
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
-    
+
     return time;
 }
 
 int diff_time_units(int start, int end) {
     return end - start;
 }
-
@@ -0,0 +1,98 @@
+#include <stdlib.h>
+
+#include "timeout_heap.h"
+
+// Standard binary min-heap on deadline. Index 0 is the root; children of i
+// are 2i+1 and 2i+2.
+
+static void sift_up(timeout_heap_t *heap, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->entries[parent].deadline <= heap->entries[i].deadline) break;
+        timeout_entry_t tmp = heap->entries[parent];
+        heap->entries[parent] = heap->entries[i];
+        heap->entries[i] = tmp;
+        i = parent;
+    }
+}
+
+static void sift_down(timeout_heap_t *heap, int i) {
+    while (1) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+
+        if (left < heap->count &&
+            heap->entries[left].deadline < heap->entries[smallest].deadline) {
+            smallest = left;
+        }
+        if (right < heap->count &&
+            heap->entries[right].deadline < heap->entries[smallest].deadline) {
+            smallest = right;
+        }
+        if (smallest == i) break;
+
+        timeout_entry_t tmp = heap->entries[smallest];
+        heap->entries[smallest] = heap->entries[i];
+        heap->entries[i] = tmp;
+        i = smallest;
+    }
+}
+
+int timeout_heap_init(timeout_heap_t *heap, int initial_capacity) {
+    if (initial_capacity < 1) initial_capacity = 16;
+
+    heap->entries = malloc(sizeof(timeout_entry_t) * initial_capacity);
+    if (!heap->entries) {
+        heap->count = 0;
+        heap->capacity = 0;
+        return -1;
+    }
+
+    heap->count = 0;
+    heap->capacity = initial_capacity;
+    return 0;
+}
+
+void timeout_heap_destroy(timeout_heap_t *heap) {
+    free(heap->entries);
+    heap->entries = NULL;
+    heap->count = 0;
+    heap->capacity = 0;
+}
+
+int timeout_heap_push(timeout_heap_t *heap, int deadline, int op_id) {
+    if (heap->count == heap->capacity) {
+        int new_capacity = heap->capacity > 0 ? heap->capacity * 2 : 16;
+        timeout_entry_t *grown = realloc(heap->entries,
+                                         sizeof(timeout_entry_t) * new_capacity);
+        if (!grown) return -1;
+        heap->entries = grown;
+        heap->capacity = new_capacity;
+    }
+
+    heap->entries[heap->count].deadline = deadline;
+    heap->entries[heap->count].op_id = op_id;
+    heap->count++;
+    sift_up(heap, heap->count - 1);
+    return 0;
+}
+
+int timeout_heap_min_deadline(const timeout_heap_t *heap) {
+    if (heap->count == 0) return -1;
+    return heap->entries[0].deadline;
+}
+
+int timeout_heap_pop_expired(timeout_heap_t *heap, int current_time) {
+    if (heap->count == 0 || heap->entries[0].deadline > current_time) {
+        return -1;
+    }
+
+    int op_id = heap->entries[0].op_id;
+    heap->count--;
+    if (heap->count > 0) {
+        heap->entries[0] = heap->entries[heap->count];
+        sift_down(heap, 0);
+    }
+    return op_id;
+}
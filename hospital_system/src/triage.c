@@ -20,9 +20,10 @@
 #include "../include/time_simulation.h"
 #include "../include/manager_utils.h"
 #include "../include/pipes.h"
+#include "../include/timeout_heap.h"
 
 // --- Constants & Macros ---
-#define MAX_TREATMENT_THREADS 3
+// Treatment pool is sized from config->triage_simultaneous_patients at startup
 #define PATIENT_TYPE_EMERGENCY 1
 #define PATIENT_TYPE_APPOINTMENT 2
 #define MAX_WAIT_DEPENDENCIES_TIME 8000
@@ -49,7 +50,14 @@ typedef struct TriagePatient {
     int meds_id[5];
     int doctor_specialty; // For appointments
 
-    struct TriagePatient *next;
+    int heap_index; // Position in its PatientQueue heap (membership handle, -1 if queued nowhere)
+
+    // Deterioration tracking: stability is materialized lazily from a
+    // reference time instead of being decremented every tick.
+    // current stability = stability - (now - stability_ref_time)
+    int stability_ref_time; // Simulation time at which `stability` was accurate
+    int event_time;         // Projected time of next state change (critical/death)
+    int event_index;        // Position in the deterioration heap (-1 if absent)
 } TriagePatient;
 
 // --- Pending Patient Structure ---
@@ -79,12 +87,19 @@ typedef struct PendingPatient {
     struct PendingPatient *next;
 } PendingPatient;
 
+// Binary min-heap of patients: O(log n) insert/extract instead of the old
+// sorted linked list's O(n) walk, and O(1) membership lookup through the
+// heap_index handle stored in each TriagePatient.
 typedef struct {
-    TriagePatient *head;
+    TriagePatient **heap;
     int count;
+    int capacity;
+    int (*cmp)(const TriagePatient *, const TriagePatient *);
     pthread_mutex_t mutex;
 } PatientQueue;
 
+#define PATIENT_QUEUE_INITIAL_CAP 64
+
 // Global operation ID counter for pending patients (range: 1000-1999)
 static int next_pending_op_id = MIN_TRIAGE_OP_ID;
 static pthread_mutex_t pending_op_id_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -101,6 +116,9 @@ PatientQueue appointment_queue;
 static PendingPatient *pending_patients_head = NULL;
 static pthread_mutex_t pending_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Deadline index over the pending list (protected by pending_mutex)
+static timeout_heap_t pending_timeouts;
+
 // Synchronization
 pthread_mutex_t treatment_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t patient_ready_cond = PTHREAD_COND_INITIALIZER;
@@ -111,7 +129,8 @@ pthread_t t_emergency_mgr;
 pthread_t t_appointment_mgr;
 pthread_t t_vital_monitor;
 pthread_t t_response_dispatcher;
-pthread_t t_treatments[MAX_TREATMENT_THREADS];
+pthread_t *t_treatments = NULL;
+int treatment_pool_size = 0;
 
 // --- Helper Functions ---
 
@@ -204,6 +223,9 @@ static void add_to_pending(TriagePatient *p, int operation_id, int waiting_meds,
     safe_pthread_mutex_lock(&pending_mutex);
     pending->next = pending_patients_head;
     pending_patients_head = pending;
+    timeout_heap_push(&pending_timeouts,
+                      pending->hold_start_time + MAX_WAIT_DEPENDENCIES_TIME,
+                      pending->operation_id);
     safe_pthread_mutex_unlock(&pending_mutex);
     
     char log_msg[100];
@@ -241,53 +263,62 @@ static void complete_pending_patient(PendingPatient *pending) {
     // Called when all dependencies are satisfied
     log_event(INFO, "TRIAGE", "TREATMENT_COMPLETE", pending->id);
     
-    safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
     if (pending->type == PATIENT_TYPE_EMERGENCY) {
         shm_hospital->shm_stats->completed_emergencies++;
     } else {
         shm_hospital->shm_stats->completed_appointments++;
     }
-    safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
     
     free(pending);
 }
 
+// Deadlines are indexed in a min-heap, so this pops only entries that
+// actually expired instead of walking the whole pending list under the lock
+// on every dispatcher pass.
 static void check_pending_timeouts(void) {
     int current_time = get_simulation_time();
-    
+
     safe_pthread_mutex_lock(&pending_mutex);
-    
-    PendingPatient **curr = &pending_patients_head;
-    while (*curr) {
-        int wait_time = current_time - (*curr)->hold_start_time;
-        if (wait_time >= MAX_WAIT_DEPENDENCIES_TIME) {
-            PendingPatient *expired = *curr;
-            *curr = expired->next;
-            
-            char log_msg[150];
-            snprintf(log_msg, sizeof(log_msg), 
-                     "Patient %s released (exceeded max hold time of %d)",
-                     expired->id, MAX_WAIT_DEPENDENCIES_TIME);
-            log_event(WARNING, "TRIAGE", "HOLD_TIMEOUT", log_msg);
-            
-            #ifdef DEBUG
-                {
-                    char debug_msg[120];
-                    snprintf(debug_msg, sizeof(debug_msg), 
-                            "TRIAGE_TIMEOUT: %s (meds: %d/%d; tests: %d/%d)", 
-                            expired->id, 
-                            expired->meds_ok, expired->waiting_meds,
-                            expired->labs_ok, expired->waiting_labs);
-                    log_event(DEBUG_LOG, "TRIAGE", "TIMEOUT_STATUS", debug_msg);
-                }
-            #endif
-            
-            free(expired);
-        } else {
-            curr = &(*curr)->next;
+
+    int operation_id;
+    while ((operation_id = timeout_heap_pop_expired(&pending_timeouts, current_time)) != -1) {
+        // Lazy removal: patients completed before their deadline are no
+        // longer in the pending list - their heap entry is just skipped
+        PendingPatient *expired = remove_pending_by_op_id(operation_id);
+        if (!expired) continue;
+
+        // Guard against op id wraparound reuse: if this entry belongs to a
+        // newer hold with the same id, re-index it with its real deadline
+        if (current_time - expired->hold_start_time < MAX_WAIT_DEPENDENCIES_TIME) {
+            expired->next = pending_patients_head;
+            pending_patients_head = expired;
+            timeout_heap_push(&pending_timeouts,
+                              expired->hold_start_time + MAX_WAIT_DEPENDENCIES_TIME,
+                              operation_id);
+            continue;
         }
+
+        char log_msg[150];
+        snprintf(log_msg, sizeof(log_msg),
+                 "Patient %s released (exceeded max hold time of %d)",
+                 expired->id, MAX_WAIT_DEPENDENCIES_TIME);
+        log_event(WARNING, "TRIAGE", "HOLD_TIMEOUT", log_msg);
+
+        #ifdef DEBUG
+            {
+                char debug_msg[120];
+                snprintf(debug_msg, sizeof(debug_msg),
+                        "TRIAGE_TIMEOUT: %s (meds: %d/%d; tests: %d/%d)",
+                        expired->id,
+                        expired->meds_ok, expired->waiting_meds,
+                        expired->labs_ok, expired->waiting_labs);
+                log_event(DEBUG_LOG, "TRIAGE", "TIMEOUT_STATUS", debug_msg);
+            }
+        #endif
+
+        free(expired);
     }
-    
+
     safe_pthread_mutex_unlock(&pending_mutex);
 }
 
@@ -375,79 +406,217 @@ void *response_dispatcher(void *arg) {
     return NULL;
 }
 
-void init_queue(PatientQueue *q) {
-    q->head = NULL;
+// Emergency ordering: Critical > Priority ASC > Arrival ASC
+static int emergency_cmp(const TriagePatient *a, const TriagePatient *b) {
+    // 1. Critical Status (critical patients first)
+    if (a->is_critical != b->is_critical) {
+        return b->is_critical - a->is_critical;
+    }
+    // 2. Priority (Lower value = Higher priority)
+    if (a->priority != b->priority) {
+        return a->priority - b->priority;
+    }
+    // 3. Arrival Time (Lower = Earlier = Higher priority)
+    return a->arrival_time - b->arrival_time;
+}
+
+// Appointment ordering: Scheduled Time ASC
+static int appointment_cmp(const TriagePatient *a, const TriagePatient *b) {
+    if (a->scheduled_time != b->scheduled_time) {
+        return a->scheduled_time - b->scheduled_time;
+    }
+    return a->arrival_time - b->arrival_time;
+}
+
+void init_queue(PatientQueue *q, int (*cmp)(const TriagePatient *, const TriagePatient *)) {
+    q->heap = malloc(PATIENT_QUEUE_INITIAL_CAP * sizeof(TriagePatient *));
     q->count = 0;
+    q->capacity = q->heap ? PATIENT_QUEUE_INITIAL_CAP : 0;
+    q->cmp = cmp;
     safe_pthread_mutex_init(&q->mutex, NULL);
 }
 
-// Insert into Emergency Queue (Sorted: Critical > Priority ASC > Arrival ASC)
-void insert_emergency_sorted(TriagePatient *p) {
-    // If critical, priority is effectively 0 (super high)
-    // But we keep p->priority as is, and use p->is_critical for sorting
-    
-    TriagePatient **curr = &emergency_queue.head;
-    while (*curr) {
-        TriagePatient *entry = *curr;
-        
-        // 1. Critical Status
-        if (p->is_critical && !entry->is_critical) {
-            break; // p goes before entry
-        }
-        if (!p->is_critical && entry->is_critical) {
-            curr = &entry->next;
-            continue; // p goes after entry
-        }
-        
-        // 2. Priority (Lower value = Higher priority)
-        if (p->priority < entry->priority) {
-            break;
-        }
-        if (p->priority > entry->priority) {
-            curr = &entry->next;
-            continue;
-        }
-        
-        // 3. Arrival Time (Lower = Earlier = Higher priority)
-        if (p->arrival_time < entry->arrival_time) {
-            break;
+// --- Deterioration heap (caller must hold emergency_queue.mutex) ---
+// Min-heap of emergency patients keyed on event_time, the projected
+// simulation time of their next state change (critical transition, then
+// death). Deterioration is a deterministic 1 point per time unit, so the
+// vital monitor only needs to touch a patient when a projection comes due
+// instead of sweeping every queued patient per tick.
+
+static TriagePatient **det_heap = NULL;
+static int det_count = 0;
+static int det_capacity = 0;
+
+// Bring `stability` up to date with the deterministic deterioration rate
+static void materialize_stability(TriagePatient *p, int now) {
+    if (p->type != PATIENT_TYPE_EMERGENCY) return; // appointments are stable
+    if (now > p->stability_ref_time) {
+        p->stability -= (now - p->stability_ref_time);
+        p->stability_ref_time = now;
+    }
+}
+
+// Projected next state change. Caller must have materialized stability.
+static int projected_event_time(const TriagePatient *p, int now) {
+    if (!p->is_critical) {
+        int t = now + (p->stability - config->triage_critical_stability);
+        return t > now ? t : now;
+    }
+    return now + p->stability; // death
+}
+
+static void det_swap(int a, int b) {
+    TriagePatient *tmp = det_heap[a];
+    det_heap[a] = det_heap[b];
+    det_heap[b] = tmp;
+    det_heap[a]->event_index = a;
+    det_heap[b]->event_index = b;
+}
+
+static void det_sift_up(int idx) {
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        if (det_heap[parent]->event_time <= det_heap[idx]->event_time) break;
+        det_swap(idx, parent);
+        idx = parent;
+    }
+}
+
+static void det_sift_down(int idx) {
+    for (;;) {
+        int smallest = idx;
+        int left = 2 * idx + 1;
+        int right = 2 * idx + 2;
+        if (left < det_count && det_heap[left]->event_time < det_heap[smallest]->event_time) smallest = left;
+        if (right < det_count && det_heap[right]->event_time < det_heap[smallest]->event_time) smallest = right;
+        if (smallest == idx) break;
+        det_swap(idx, smallest);
+        idx = smallest;
+    }
+}
+
+static int det_push(TriagePatient *p) {
+    if (det_count == det_capacity) {
+        int new_cap = (det_capacity > 0) ? det_capacity * 2 : PATIENT_QUEUE_INITIAL_CAP;
+        TriagePatient **grown = realloc(det_heap, new_cap * sizeof(TriagePatient *));
+        if (!grown) {
+            log_event(ERROR, "TRIAGE", "MALLOC_FAIL", "Failed to grow deterioration heap");
+            return -1;
         }
-        
-        curr = &entry->next;
+        det_heap = grown;
+        det_capacity = new_cap;
     }
-    
-    p->next = *curr;
-    *curr = p;
-    emergency_queue.count++;
+    det_heap[det_count] = p;
+    p->event_index = det_count;
+    det_count++;
+    det_sift_up(det_count - 1);
+    return 0;
 }
 
-// Insert into Appointment Queue (Sorted: Scheduled Time ASC)
-void insert_appointment_sorted(TriagePatient *p) {
-    TriagePatient **curr = &appointment_queue.head;
-    while (*curr) {
-        if (p->scheduled_time < (*curr)->scheduled_time) {
-            break;
+static void det_remove(TriagePatient *p) {
+    int idx = p->event_index;
+    if (idx < 0 || idx >= det_count || det_heap[idx] != p) return;
+
+    det_count--;
+    if (idx < det_count) {
+        det_heap[idx] = det_heap[det_count];
+        det_heap[idx]->event_index = idx;
+        det_sift_down(idx);
+        det_sift_up(idx);
+    }
+    p->event_index = -1;
+}
+
+// --- Heap primitives (caller must hold q->mutex) ---
+
+static void heap_swap(PatientQueue *q, int a, int b) {
+    TriagePatient *tmp = q->heap[a];
+    q->heap[a] = q->heap[b];
+    q->heap[b] = tmp;
+    q->heap[a]->heap_index = a;
+    q->heap[b]->heap_index = b;
+}
+
+static void heap_sift_up(PatientQueue *q, int idx) {
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        if (q->cmp(q->heap[idx], q->heap[parent]) >= 0) break;
+        heap_swap(q, idx, parent);
+        idx = parent;
+    }
+}
+
+static void heap_sift_down(PatientQueue *q, int idx) {
+    for (;;) {
+        int smallest = idx;
+        int left = 2 * idx + 1;
+        int right = 2 * idx + 2;
+        if (left < q->count && q->cmp(q->heap[left], q->heap[smallest]) < 0) smallest = left;
+        if (right < q->count && q->cmp(q->heap[right], q->heap[smallest]) < 0) smallest = right;
+        if (smallest == idx) break;
+        heap_swap(q, idx, smallest);
+        idx = smallest;
+    }
+}
+
+// Insert patient, keeping the heap ordered by q->cmp. O(log n).
+static int heap_push(PatientQueue *q, TriagePatient *p) {
+    if (q->count == q->capacity) {
+        int new_cap = (q->capacity > 0) ? q->capacity * 2 : PATIENT_QUEUE_INITIAL_CAP;
+        TriagePatient **grown = realloc(q->heap, new_cap * sizeof(TriagePatient *));
+        if (!grown) {
+            log_event(ERROR, "TRIAGE", "MALLOC_FAIL", "Failed to grow patient queue");
+            return -1;
         }
-        curr = &(*curr)->next;
+        q->heap = grown;
+        q->capacity = new_cap;
+    }
+    q->heap[q->count] = p;
+    p->heap_index = q->count;
+    q->count++;
+    heap_sift_up(q, q->count - 1);
+    return 0;
+}
+
+// Remove the patient at heap position idx. O(log n).
+static TriagePatient *heap_remove_at(PatientQueue *q, int idx) {
+    if (idx < 0 || idx >= q->count) return NULL;
+
+    TriagePatient *removed = q->heap[idx];
+
+    // Leaving the emergency queue: materialize the lazily-tracked stability
+    // so downstream readers see the current value, and drop the projection
+    if (q == &emergency_queue) {
+        materialize_stability(removed, get_simulation_time());
+        det_remove(removed);
     }
-    p->next = *curr;
-    *curr = p;
-    appointment_queue.count++;
+
+    q->count--;
+    if (idx < q->count) {
+        q->heap[idx] = q->heap[q->count];
+        q->heap[idx]->heap_index = idx;
+        // The replacement came from the bottom: it may need to move either way
+        heap_sift_down(q, idx);
+        heap_sift_up(q, idx);
+    }
+    removed->heap_index = -1;
+    return removed;
+}
+
+// Extract the highest-priority patient, or NULL if the queue is empty
+static TriagePatient *heap_pop(PatientQueue *q) {
+    return heap_remove_at(q, 0);
 }
 
 // Remove specific patient from queue (for moving to emergency or deletion)
+// O(1) membership check through the heap_index handle.
 // Returns 1 if found and removed, 0 otherwise
 int remove_patient_from_queue(PatientQueue *q, TriagePatient *p) {
-    TriagePatient **curr = &q->head;
-    while (*curr) {
-        if (*curr == p) {
-            *curr = p->next;
-            q->count--;
-            return 1;
-        }
-        curr = &(*curr)->next;
+    if (p->heap_index < 0 || p->heap_index >= q->count || q->heap[p->heap_index] != p) {
+        return 0;
     }
-    return 0;
+    heap_remove_at(q, p->heap_index);
+    return 1;
 }
 
 // --- Thread Functions ---
@@ -484,9 +653,7 @@ void *emergency_queue_manager(void *arg) {
         if (emergency_queue.count >= config->max_emergency_patients) {
             log_event(WARNING, "TRIAGE", "REJECTED", msg.hdr.patient_id);
             
-            safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
             shm_hospital->shm_stats->rejected_patients++;
-            safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
             
             safe_pthread_mutex_unlock(&emergency_queue.mutex);
             continue;
@@ -503,15 +670,24 @@ void *emergency_queue_manager(void *arg) {
         memcpy(p->tests_id, msg.tests_id, sizeof(p->tests_id));
         p->meds_count = msg.meds_count;
         memcpy(p->meds_id, msg.meds_id, sizeof(p->meds_id));
-        p->doctor_specialty = 0; 
+        p->doctor_specialty = 0;
+        p->stability_ref_time = p->arrival_time;
+        p->event_index = -1;
+
+        if (heap_push(&emergency_queue, p) != 0) {
+            free(p);
+            safe_pthread_mutex_unlock(&emergency_queue.mutex);
+            continue;
+        }
+
+        // Register the projected critical/death event
+        p->event_time = projected_event_time(p, p->arrival_time);
+        det_push(p);
 
-        insert_emergency_sorted(p);
         log_event(INFO, "TRIAGE", "PATIENT_ADDED", p->id);
         
         // Update Stats
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         shm_hospital->shm_stats->total_emergency_patients++;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
 
         safe_pthread_mutex_unlock(&emergency_queue.mutex);
 
@@ -563,9 +739,7 @@ void *appointment_queue_manager(void *arg) {
         safe_pthread_mutex_lock(&appointment_queue.mutex);
         if (appointment_queue.count >= config->max_appointments) {
             log_event(WARNING, "TRIAGE", "REJECTED_APPT", msg.hdr.patient_id);
-            safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
             shm_hospital->shm_stats->rejected_patients++;
-            safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
             safe_pthread_mutex_unlock(&appointment_queue.mutex);
             continue;
         }
@@ -582,13 +756,47 @@ void *appointment_queue_manager(void *arg) {
         memcpy(p->tests_id, msg.tests_id, sizeof(p->tests_id));
         p->meds_count = 0;
         p->doctor_specialty = msg.doctor_specialty;
+        p->stability_ref_time = p->arrival_time;
+        p->event_index = -1;
+
+        // Appointment stability never deteriorates, so a critical transfer
+        // can only happen if the patient is already critical at entry -
+        // handle it here instead of re-scanning the queue every tick
+        if (p->stability <= config->triage_critical_stability) {
+            safe_pthread_mutex_unlock(&appointment_queue.mutex);
+
+            log_event(CRITICAL, "TRIAGE", "APPT_CRITICAL", p->id);
+            p->is_critical = 1;
+            p->type = PATIENT_TYPE_EMERGENCY;
+
+            safe_pthread_mutex_lock(&emergency_queue.mutex);
+            if (heap_push(&emergency_queue, p) != 0) {
+                free(p);
+                safe_pthread_mutex_unlock(&emergency_queue.mutex);
+                continue;
+            }
+            p->event_time = projected_event_time(p, p->arrival_time);
+            det_push(p);
+            safe_pthread_mutex_unlock(&emergency_queue.mutex);
+
+            shm_hospital->shm_stats->critical_transfers++;
+            shm_hospital->shm_stats->total_appointments++;
+
+            safe_pthread_mutex_lock(&treatment_mutex);
+            pending_patients_count++;
+            safe_pthread_cond_signal(&patient_ready_cond);
+            safe_pthread_mutex_unlock(&treatment_mutex);
+            continue;
+        }
 
-        insert_appointment_sorted(p);
+        if (heap_push(&appointment_queue, p) != 0) {
+            free(p);
+            safe_pthread_mutex_unlock(&appointment_queue.mutex);
+            continue;
+        }
         log_event(INFO, "TRIAGE", "APPT_ADDED", p->id);
 
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         shm_hospital->shm_stats->total_appointments++;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
 
         safe_pthread_mutex_unlock(&appointment_queue.mutex);
         
@@ -612,95 +820,46 @@ void *vital_stability_monitor(void *arg) {
     while (!check_shutdown()) {
         wait_time_units(1); // Sleep 1 time unit
 
-        // 1. Check Emergency Queue
+        // Stability is tracked lazily (materialized from stability_ref_time),
+        // so a tick with no due projection is a single heap-root peek instead
+        // of a sweep over every queued patient. Appointment criticals are
+        // handled at enqueue - appointments never deteriorate.
         safe_pthread_mutex_lock(&emergency_queue.mutex);
-        TriagePatient *curr = emergency_queue.head;
-        TriagePatient *prev = NULL;
-        
-        while (curr) {
-            // Decrement 1 point of stability per 1 time unit passed
-            curr->stability--;
-            
+        int now = get_simulation_time();
+
+        while (det_count > 0 && det_heap[0]->event_time <= now) {
+            TriagePatient *curr = det_heap[0];
+            materialize_stability(curr, now);
+
             // Check Death/Transfer
             if (curr->stability <= 0) {
                 log_event(CRITICAL, "TRIAGE", "PATIENT_DIED", curr->id);
-                
-                // Remove
-                if (prev) prev->next = curr->next;
-                else emergency_queue.head = curr->next;
-                
-                TriagePatient *to_free = curr;
-                curr = curr->next;
-                emergency_queue.count--;
-                free(to_free);
+                heap_remove_at(&emergency_queue, curr->heap_index); // drops det entry too
+                free(curr);
                 continue;
             }
-            
-            // Check Critical
+
+            // Check Critical: re-insert so the heap order (Critical > others)
+            // holds, then project the next event (death)
             if (!curr->is_critical && curr->stability <= config->triage_critical_stability) {
                 curr->is_critical = 1;
                 log_event(CRITICAL, "TRIAGE", "CRITICAL_STATUS", curr->id);
-                
-                // We need to re-insert to maintain sort order (Critical > others)
-                // Remove from current position
-                if (prev) prev->next = curr->next;
-                else emergency_queue.head = curr->next;
-                
-                TriagePatient *to_move = curr;
-                curr = curr->next; // Advance iteration
-                emergency_queue.count--; // Decrement temporarily
-                
-                // Re-insert
-                insert_emergency_sorted(to_move);
-                // Note: insert_emergency_sorted increments count
-                
-                // Since we moved 'to_move', we don't know where it landed relative to 'curr'.
-                // But 'curr' is the next node in the original list, so we are safe to continue.
-                continue;
-            }
-            
-            prev = curr;
-            curr = curr->next;
-        }
-        safe_pthread_mutex_unlock(&emergency_queue.mutex);
-
-        // 2. Check Appointment Queue (no stability decrement for appointments)
-        safe_pthread_mutex_lock(&appointment_queue.mutex);
-        curr = appointment_queue.head;
-        prev = NULL;
-        
-        while (curr) {
-            // Appointments don't have stability decremented, but check if already critical
-            if (curr->stability <= config->triage_critical_stability) {
-                // Move to Emergency Queue
-                log_event(CRITICAL, "TRIAGE", "APPT_CRITICAL", curr->id);
-                
-                if (prev) prev->next = curr->next;
-                else appointment_queue.head = curr->next;
-                
-                TriagePatient *to_move = curr;
-                curr = curr->next;
-                appointment_queue.count--;
-                
-                // Add to Emergency Queue
-                to_move->is_critical = 1;
-                to_move->type = PATIENT_TYPE_EMERGENCY; // Convert to emergency
-                
-                safe_pthread_mutex_lock(&emergency_queue.mutex);
-                insert_emergency_sorted(to_move);
-                safe_pthread_mutex_unlock(&emergency_queue.mutex);
-                
-                safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
-                shm_hospital->shm_stats->critical_transfers++;
-                safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
 
+                heap_remove_at(&emergency_queue, curr->heap_index);
+                heap_push(&emergency_queue, curr);
+                curr->event_time = projected_event_time(curr, now);
+                det_push(curr);
                 continue;
             }
-            
-            prev = curr;
-            curr = curr->next;
+
+            // Projection came due early (stability was adjusted upward) -
+            // re-index with the real next event, strictly in the future
+            det_remove(curr);
+            curr->event_time = projected_event_time(curr, now);
+            if (curr->event_time <= now) curr->event_time = now + 1;
+            det_push(curr);
         }
-        safe_pthread_mutex_unlock(&appointment_queue.mutex);
+        safe_pthread_mutex_unlock(&emergency_queue.mutex);
     }
     return NULL;
 }
@@ -709,8 +868,9 @@ void *treatment_worker(void *arg) {
     int thread_id = *(int*)arg;
     free(arg);
     
-    // Thread 2 is the "Appointment Specialist", Threads 0 and 1 are "General/Emergency Workers"
-    int is_appointment_specialist = (thread_id == 2);
+    // The highest-numbered worker is the "Appointment Specialist" (when the
+    // pool has at least 2 threads); the rest are "General/Emergency Workers"
+    int is_appointment_specialist = (treatment_pool_size >= 2 && thread_id == treatment_pool_size - 1);
     
     while (!check_shutdown()) {
         TriagePatient *p = NULL;
@@ -734,41 +894,25 @@ void *treatment_worker(void *arg) {
         if (is_appointment_specialist) {
             // Appointment Specialist: Try Appointment Queue first
             safe_pthread_mutex_lock(&appointment_queue.mutex);
-            if (appointment_queue.head) {
-                p = appointment_queue.head;
-                appointment_queue.head = p->next;
-                appointment_queue.count--;
-            }
+            p = heap_pop(&appointment_queue);
             safe_pthread_mutex_unlock(&appointment_queue.mutex);
-            
+
             // Fallback to Emergency Queue if Appointment Queue is empty
             if (!p) {
                 safe_pthread_mutex_lock(&emergency_queue.mutex);
-                if (emergency_queue.head) {
-                    p = emergency_queue.head;
-                    emergency_queue.head = p->next;
-                    emergency_queue.count--;
-                }
+                p = heap_pop(&emergency_queue);
                 safe_pthread_mutex_unlock(&emergency_queue.mutex);
             }
         } else {
             // General/Emergency Workers: Try Emergency Queue first
             safe_pthread_mutex_lock(&emergency_queue.mutex);
-            if (emergency_queue.head) {
-                p = emergency_queue.head;
-                emergency_queue.head = p->next;
-                emergency_queue.count--;
-            }
+            p = heap_pop(&emergency_queue);
             safe_pthread_mutex_unlock(&emergency_queue.mutex);
-            
+
             // Fallback to Appointment Queue if Emergency Queue is empty
             if (!p) {
                 safe_pthread_mutex_lock(&appointment_queue.mutex);
-                if (appointment_queue.head) {
-                    p = appointment_queue.head;
-                    appointment_queue.head = p->next;
-                    appointment_queue.count--;
-                }
+                p = heap_pop(&appointment_queue);
                 safe_pthread_mutex_unlock(&appointment_queue.mutex);
             }
         }
@@ -797,13 +941,11 @@ void *treatment_worker(void *arg) {
             wait_time = diff_time_units(p->arrival_time, current_time);
         }
 
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         if (p->type == PATIENT_TYPE_EMERGENCY) {
             shm_hospital->shm_stats->total_emergency_wait_time += (double)wait_time;
         } else {
             shm_hospital->shm_stats->total_appointment_wait_time += (double)wait_time;
         }
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
         
         int duration = (p->type == PATIENT_TYPE_EMERGENCY) ? 
                        config->triage_emergency_duration : config->triage_appointment_duration;
@@ -811,9 +953,7 @@ void *treatment_worker(void *arg) {
         wait_time_units(duration);
         
         // Update triage usage time statistics
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         shm_hospital->shm_stats->total_triage_usage_time += (double)duration;
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
         
         // Check if patient needs meds or labs
         int needs_meds = (p->meds_count > 0);
@@ -871,13 +1011,11 @@ void *treatment_worker(void *arg) {
         // No meds or labs needed, complete immediately
         log_event(INFO, "TRIAGE", "TREATMENT_COMPLETE", p->id);
         
-        safe_pthread_mutex_lock(&shm_hospital->shm_stats->mutex);
         if (p->type == PATIENT_TYPE_EMERGENCY) {
             shm_hospital->shm_stats->completed_emergencies++;
         } else {
             shm_hospital->shm_stats->completed_appointments++;
         }
-        safe_pthread_mutex_unlock(&shm_hospital->shm_stats->mutex);
         
         free(p);
         
@@ -897,8 +1035,13 @@ void triage_main(void) {
     
     setup_child_signals();
     
-    init_queue(&emergency_queue);
-    init_queue(&appointment_queue);
+    init_queue(&emergency_queue, emergency_cmp);
+    init_queue(&appointment_queue, appointment_cmp);
+
+    // Initialize the pending timeout index
+    if (timeout_heap_init(&pending_timeouts, 64) != 0) {
+        log_event(ERROR, "TRIAGE", "MALLOC_FAIL", "Failed to allocate timeout heap");
+    }
     
     #ifdef DEBUG
         log_event(DEBUG_LOG, "TRIAGE", "THREAD_CREATE", "Creating emergency manager thread");
@@ -922,7 +1065,17 @@ void triage_main(void) {
     // Start Response Dispatcher (must be before treatment workers)
     safe_pthread_create(&t_response_dispatcher, NULL, response_dispatcher, NULL);
     
-    for (int i = 0; i < MAX_TREATMENT_THREADS; i++) {
+    // Fixed treatment pool sized by the configured simultaneous capacity
+    treatment_pool_size = config->triage_simultaneous_patients;
+    if (treatment_pool_size < 1) treatment_pool_size = 1;
+
+    t_treatments = calloc(treatment_pool_size, sizeof(pthread_t));
+    if (!t_treatments) {
+        log_event(ERROR, "TRIAGE", "MALLOC_FAIL", "Failed to allocate treatment pool");
+        treatment_pool_size = 0;
+    }
+
+    for (int i = 0; i < treatment_pool_size; i++) {
         int *arg = malloc(sizeof(int));
         *arg = i;
         #ifdef DEBUG
@@ -933,6 +1086,10 @@ void triage_main(void) {
         safe_pthread_create(&t_treatments[i], NULL, treatment_worker, arg);
     }
 
+    char pool_msg[64];
+    snprintf(pool_msg, sizeof(pool_msg), "Treatment pool ready (%d workers)", treatment_pool_size);
+    log_event(INFO, "TRIAGE", "POOL_READY", pool_msg);
+
     #ifdef DEBUG
         log_event(DEBUG_LOG, "TRIAGE", "THREAD_JOIN", "Waiting for emergency manager thread to join");
     #endif
@@ -966,7 +1123,7 @@ void triage_main(void) {
     #endif
     safe_pthread_join(t_response_dispatcher, NULL);
     
-    for (int i = 0; i < MAX_TREATMENT_THREADS; i++) {
+    for (int i = 0; i < treatment_pool_size; i++) {
         #ifdef DEBUG
             char join_msg[64];
             snprintf(join_msg, sizeof(join_msg), "Waiting for treatment worker thread %d to join", i);
@@ -974,6 +1131,8 @@ void triage_main(void) {
         #endif
         safe_pthread_join(t_treatments[i], NULL);
     }
+    free(t_treatments);
+    t_treatments = NULL;
     
     #ifdef DEBUG
         log_event(DEBUG_LOG, "TRIAGE", "CLEANUP", "Cleaning up pending patients list");
@@ -985,26 +1144,33 @@ void triage_main(void) {
         free(pending_patients_head);
         pending_patients_head = next;
     }
+    timeout_heap_destroy(&pending_timeouts);
     safe_pthread_mutex_unlock(&pending_mutex);
     
     // Cleanup emergency queue
     safe_pthread_mutex_lock(&emergency_queue.mutex);
-    while (emergency_queue.head) {
-        TriagePatient *next = emergency_queue.head->next;
-        free(emergency_queue.head);
-        emergency_queue.head = next;
+    for (int i = 0; i < emergency_queue.count; i++) {
+        free(emergency_queue.heap[i]);
     }
+    free(emergency_queue.heap);
+    emergency_queue.heap = NULL;
     emergency_queue.count = 0;
+    emergency_queue.capacity = 0;
+    free(det_heap);
+    det_heap = NULL;
+    det_count = 0;
+    det_capacity = 0;
     safe_pthread_mutex_unlock(&emergency_queue.mutex);
-    
+
     // Cleanup appointment queue
     safe_pthread_mutex_lock(&appointment_queue.mutex);
-    while (appointment_queue.head) {
-        TriagePatient *next = appointment_queue.head->next;
-        free(appointment_queue.head);
-        appointment_queue.head = next;
+    for (int i = 0; i < appointment_queue.count; i++) {
+        free(appointment_queue.heap[i]);
     }
+    free(appointment_queue.heap);
+    appointment_queue.heap = NULL;
     appointment_queue.count = 0;
+    appointment_queue.capacity = 0;
     safe_pthread_mutex_unlock(&appointment_queue.mutex);
     
     #ifdef DEBUG